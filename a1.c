@@ -1,25 +1,233 @@
+    #define _GNU_SOURCE
     #include <stdio.h>
     #include <stdlib.h>
     #include <stdbool.h>
     #include <string.h>
     #include <time.h>
+    #include <stdint.h>
+    #include <omp.h>
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <errno.h>
+    #include <linux/perf_event.h>
 
     typedef struct Nodo {
         int vertice;
         struct Nodo* prox;
     } Nodo;
 
+    // Índice de adjacência híbrido: listas ordenadas compactas para todos os
+    // vértices e, acima do limiar de grau, um conjunto hash (ou bitmap, quando
+    // os vizinhos ocupam uma faixa densa de IDs) para testes em O(1).
+    typedef struct ConjuntoHash {
+        int* chaves;
+        int mascara;
+    } ConjuntoHash;
+
+    typedef struct IndiceAdjacencia {
+        int limiar;
+        int num_hubs;
+        int num_bitmaps;
+        int* grau;
+        int** vizinhos;
+        int* arestas;
+        ConjuntoHash** hashes;
+        uint64_t** bitmaps;
+        int* base_bitmap;
+        int* fim_bitmap;
+        size_t bytes_listas;
+        size_t bytes_hubs;
+    } IndiceAdjacencia;
+
+    // Formato comprimido: cada lista ordenada vira o primeiro vizinho seguido
+    // das diferenças, todos em varint. Listas maiores que BLOCO_COMPRIMIDO têm
+    // um índice de saltos com o primeiro vizinho e o deslocamento (em bytes)
+    // de cada bloco a partir do segundo.
+    #define BLOCO_COMPRIMIDO 32
+
+    typedef struct AdjacenciaComprimida {
+        int V;
+        uint8_t* dados;
+        uint64_t* inicio;
+        int* grau;
+        int64_t* primeiro_salto_de;
+        int* valor_salto;
+        uint32_t* deslocamento_salto;
+        size_t bytes_dados;
+        size_t bytes_indice;
+    } AdjacenciaComprimida;
+
     typedef struct Grafo {
         int V;
         Nodo** adj;
+        IndiceAdjacencia* indice;
+        AdjacenciaComprimida* comprimida;
     } Grafo;
 
+    // Tipo das contagens de cliques: 64 bits sem sinal; com -DCONTAGEM_128,
+    // 128 bits (o printf não formata esse tipo, daí formatar_contagem).
+    #ifdef CONTAGEM_128
+    typedef unsigned __int128 contagem_t;
+    #else
+    typedef uint64_t contagem_t;
+    #endif
+
+    const char* formatar_contagem(contagem_t c, char* texto) {
+        char invertido[48];
+        int n = 0;
+        do {
+            invertido[n++] = (char)('0' + (int)(c % 10));
+            c /= 10;
+        } while (c > 0);
+        for (int i = 0; i < n; i++) {
+            texto[i] = invertido[n - 1 - i];
+        }
+        texto[n] = '\0';
+        return texto;
+    }
+
     typedef struct Lista {
         int* vertices;
         int tamanho;
         struct Lista* prox;
     } Lista;
 
+    // Contadores da busca por thread, compilados só com -DINSTRUMENTAR. Cada
+    // thread escreve na própria entrada (alinhada em linha de cache); a soma
+    // é feita no fim. Com --trace, os intervalos ocupados de cada thread são
+    // gravados no formato de trilha do Chrome (chrome://tracing, Perfetto).
+    #ifdef INSTRUMENTAR
+    #define INSTR(x) x
+    #define MAX_PROFUNDIDADE 32
+    #define MAX_EVENTOS (1 << 20)
+
+    typedef struct EventoTrilha {
+        double inicio;
+        double fim;
+    } EventoTrilha;
+
+    typedef struct Instrumentacao {
+        uint64_t quadros[MAX_PROFUNDIDADE];
+        uint64_t candidatos;
+        uint64_t sondagens;
+        uint64_t alocacoes;
+        double ocupado;
+        EventoTrilha* eventos;
+        int num_eventos;
+    } __attribute__((aligned(64))) Instrumentacao;
+
+    Instrumentacao* instrumentacao = NULL;
+    double origem_trilha;
+    static __thread Instrumentacao* instr_thread = NULL;
+
+    static inline Instrumentacao* instr(void) {
+        if (instr_thread == NULL) {
+            instr_thread = &instrumentacao[omp_get_thread_num()];
+        }
+        return instr_thread;
+    }
+
+    static inline void contar_quadro(int profundidade) {
+        instr()->quadros[profundidade < MAX_PROFUNDIDADE ? profundidade : MAX_PROFUNDIDADE - 1]++;
+    }
+
+    // Soma o tempo da raiz e, com trilha, estende o último intervalo se a
+    // thread não ficou parada entre as duas raízes (evita um evento por raiz).
+    void registrar_ocupado(double inicio) {
+        double fim = omp_get_wtime();
+        Instrumentacao* in = instr();
+        in->ocupado += fim - inicio;
+        if (in->eventos == NULL) {
+            return;
+        }
+        if (in->num_eventos > 0 && inicio - in->eventos[in->num_eventos - 1].fim < 20e-6) {
+            in->eventos[in->num_eventos - 1].fim = fim;
+        } else if (in->num_eventos < MAX_EVENTOS) {
+            in->eventos[in->num_eventos].inicio = inicio;
+            in->eventos[in->num_eventos].fim = fim;
+            in->num_eventos++;
+        }
+    }
+
+    void iniciar_instrumentacao(int num_threads, bool trilha) {
+        instrumentacao = (Instrumentacao*)aligned_alloc(64, num_threads * sizeof(Instrumentacao));
+        memset(instrumentacao, 0, num_threads * sizeof(Instrumentacao));
+        for (int t = 0; t < num_threads && trilha; t++) {
+            instrumentacao[t].eventos = (EventoTrilha*)malloc(MAX_EVENTOS * sizeof(EventoTrilha));
+        }
+        origem_trilha = omp_get_wtime();
+    }
+
+    void gravar_trilha(const char* arquivo, int num_threads) {
+        FILE* f = fopen(arquivo, "w");
+        if (f == NULL) {
+            fprintf(stderr, "Erro ao criar %s\n", arquivo);
+            return;
+        }
+        fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        for (int t = 0; t < num_threads; t++) {
+            fprintf(f, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}},\n", t, t);
+        }
+        bool primeiro = true;
+        for (int t = 0; t < num_threads; t++) {
+            Instrumentacao* in = &instrumentacao[t];
+            for (int e = 0; e < in->num_eventos; e++) {
+                fprintf(f, "%s{\"name\": \"ocupado\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                        primeiro ? "" : ",\n", t, (in->eventos[e].inicio - origem_trilha) * 1e6,
+                        (in->eventos[e].fim - in->eventos[e].inicio) * 1e6);
+                primeiro = false;
+            }
+        }
+        fprintf(f, "\n]}\n");
+        fclose(f);
+        printf("Trilha gravada em %s\n", arquivo);
+    }
+
+    // Ocioso = duração da contagem menos o tempo em raízes (espera na
+    // barreira implícita e no escalonador do OpenMP).
+    void relatar_instrumentacao(int num_threads, double tempo_total, const char* trilha) {
+        Instrumentacao soma;
+        memset(&soma, 0, sizeof(soma));
+        printf("Instrumentação (%d threads):\n", num_threads);
+        for (int t = 0; t < num_threads; t++) {
+            Instrumentacao* in = &instrumentacao[t];
+            uint64_t quadros = 0;
+            for (int d = 0; d < MAX_PROFUNDIDADE; d++) {
+                soma.quadros[d] += in->quadros[d];
+                quadros += in->quadros[d];
+            }
+            soma.candidatos += in->candidatos;
+            soma.sondagens += in->sondagens;
+            soma.alocacoes += in->alocacoes;
+            printf("  Thread %d: ocupado %.6f s, ocioso %.6f s, quadros %llu, candidatos %llu, sondagens %llu, alocações %llu\n",
+                   t, in->ocupado, tempo_total > in->ocupado ? tempo_total - in->ocupado : 0.0,
+                   (unsigned long long)quadros, (unsigned long long)in->candidatos,
+                   (unsigned long long)in->sondagens, (unsigned long long)in->alocacoes);
+        }
+        printf("  Quadros por profundidade:");
+        for (int d = 0; d < MAX_PROFUNDIDADE; d++) {
+            if (soma.quadros[d] > 0) {
+                printf(" %d:%llu", d, (unsigned long long)soma.quadros[d]);
+            }
+        }
+        printf("\n  Total: candidatos %llu, sondagens %llu, alocações %llu\n",
+               (unsigned long long)soma.candidatos, (unsigned long long)soma.sondagens,
+               (unsigned long long)soma.alocacoes);
+        if (trilha != NULL) {
+            gravar_trilha(trilha, num_threads);
+        }
+        for (int t = 0; t < num_threads; t++) {
+            free(instrumentacao[t].eventos);
+        }
+        free(instrumentacao);
+    }
+    #else
+    #define INSTR(x)
+    #endif
+
     Nodo* criar_nodo(int vertice) {
         Nodo* novo_nodo = (Nodo*)malloc(sizeof(Nodo));
         novo_nodo->vertice = vertice;
@@ -34,6 +242,8 @@
         for (int i = 0; i < V; i++) {
             g->adj[i] = NULL;
         }
+        g->indice = NULL;
+        g->comprimida = NULL;
         return g;
     }
 
@@ -65,6 +275,7 @@
     }
 
     Lista* criar_lista(int* clique, int tamanho) {
+        INSTR(instr()->alocacoes += 2);
         Lista* nova_lista = (Lista*)malloc(sizeof(Lista));
         nova_lista->vertices = (int*)malloc(tamanho * sizeof(int));
         for (int i = 0; i < tamanho; i++) {
@@ -87,7 +298,81 @@
         return topo;
     }
 
+    static inline uint32_t espalhar(int x) {
+        return (uint32_t)x * 2654435761u;
+    }
+
+    bool hash_contem(ConjuntoHash* h, int x) {
+        uint32_t i = espalhar(x) & h->mascara;
+        while (h->chaves[i] != -1) {
+            if (h->chaves[i] == x) {
+                return true;
+            }
+            i = (i + 1) & h->mascara;
+        }
+        return false;
+    }
+
+    bool lista_contem(const int* lista, int n, int x) {
+        if (n <= 8) {
+            for (int i = 0; i < n && lista[i] <= x; i++) {
+                if (lista[i] == x) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        int lo = 0, hi = n - 1;
+        while (lo <= hi) {
+            int meio = (lo + hi) >> 1;
+            if (lista[meio] == x) {
+                return true;
+            }
+            if (lista[meio] < x) {
+                lo = meio + 1;
+            } else {
+                hi = meio - 1;
+            }
+        }
+        return false;
+    }
+
+    bool hub_contem(IndiceAdjacencia* ind, int v, int x) {
+        if (ind->bitmaps[v] != NULL) {
+            if (x < ind->base_bitmap[v] || x > ind->fim_bitmap[v]) {
+                return false;
+            }
+            int bit = x - ind->base_bitmap[v];
+            return (ind->bitmaps[v][bit >> 6] >> (bit & 63)) & 1;
+        }
+        return hash_contem(ind->hashes[v], x);
+    }
+
+    // Escolhe a estratégia por consulta: se um dos extremos é hub, usa o
+    // conjunto dele (o grafo é não direcionado); senão, busca na menor lista.
+    bool existe_aresta(IndiceAdjacencia* ind, int u, int v) {
+        if (ind->grau[u] >= ind->limiar) {
+            return hub_contem(ind, u, v);
+        }
+        if (ind->grau[v] >= ind->limiar) {
+            return hub_contem(ind, v, u);
+        }
+        if (ind->grau[u] <= ind->grau[v]) {
+            return lista_contem(ind->vizinhos[u], ind->grau[u], v);
+        }
+        return lista_contem(ind->vizinhos[v], ind->grau[v], u);
+    }
+
     bool conexao_completa(Grafo* g, int* clique, int tamanho, int vizinho) {
+        if (g->indice != NULL) {
+            for (int i = 0; i < tamanho; i++) {
+                INSTR(instr()->sondagens++);
+                if (!existe_aresta(g->indice, clique[i], vizinho)) {
+                    return false;
+                }
+            }
+            return true;
+        }
         for (int i = 0; i < tamanho; i++) {
             int vertice = clique[i];
             Nodo* adj = g->adj[vertice];
@@ -108,6 +393,24 @@
         return true;
     }
 
+    // Vizinhos de "v" com ID maior que "v": os únicos candidatos a estender uma
+    // clique cujo último vértice é "v". Requer o índice.
+    const int* candidatos_apos(Grafo* g, int v, int* n) {
+        IndiceAdjacencia* ind = g->indice;
+        const int* lista = ind->vizinhos[v];
+        int lo = 0, hi = ind->grau[v];
+        while (lo < hi) {
+            int meio = (lo + hi) >> 1;
+            if (lista[meio] <= v) {
+                lo = meio + 1;
+            } else {
+                hi = meio;
+            }
+        }
+        *n = ind->grau[v] - lo;
+        return lista + lo;
+    }
+
     bool contem(int* array, int tamanho, int elemento) {
         for (int i = 0; i < tamanho; i++) {
             if (array[i] == elemento) {
@@ -117,9 +420,202 @@
         return false;
     }
 
-    int contagem_de_cliques_serial(Grafo* g, int k, char* schedule) {
+    typedef struct Reordenacao {
+        int* novo_para_original;
+        int* original_para_novo;
+    } Reordenacao;
+
+    int id_original(Reordenacao* r, int v) {
+        return r == NULL ? v : r->novo_para_original[v];
+    }
+
+    // Escreve a clique encontrada com os IDs do arquivo de entrada (ordenados).
+    void registrar_clique(FILE* saida, Reordenacao* r, int* clique, int tamanho) {
+        if (saida == NULL) {
+            return;
+        }
+        int originais[tamanho];
+        for (int i = 0; i < tamanho; i++) {
+            int x = id_original(r, clique[i]);
+            int j = i;
+            while (j > 0 && originais[j - 1] > x) {
+                originais[j] = originais[j - 1];
+                j--;
+            }
+            originais[j] = x;
+        }
+        #pragma omp critical(listagem)
+        {
+            for (int i = 0; i < tamanho; i++) {
+                fprintf(saida, "%d%c", originais[i], i + 1 < tamanho ? ' ' : '\n');
+            }
+        }
+    }
+
+    // Cursor que decodifica a lista comprimida de um vértice sob demanda.
+    typedef struct Cursor {
+        const AdjacenciaComprimida* a;
+        const uint8_t* p;
+        int v;
+        int bloco;
+        int num_blocos;
+        int restantes;
+        int valor;
+        bool fim;
+    } Cursor;
+
+    static inline int ler_varint(const uint8_t** p) {
+        uint32_t x = 0;
+        int deslocamento = 0;
+        uint8_t byte;
+        do {
+            byte = *(*p)++;
+            x |= (uint32_t)(byte & 0x7f) << deslocamento;
+            deslocamento += 7;
+        } while (byte & 0x80);
+        return (int)x;
+    }
+
+    static inline void cursor_entrar_bloco(Cursor* c, int bloco) {
+        const AdjacenciaComprimida* a = c->a;
+        c->bloco = bloco;
+        if (bloco == 0) {
+            c->p = a->dados + a->inicio[c->v];
+            c->valor = ler_varint(&c->p);
+        } else {
+            int64_t salto = a->primeiro_salto_de[c->v] + bloco - 1;
+            c->p = a->dados + a->inicio[c->v] + a->deslocamento_salto[salto];
+            c->valor = a->valor_salto[salto];
+        }
+        int resto = a->grau[c->v] - bloco * BLOCO_COMPRIMIDO;
+        c->restantes = (resto < BLOCO_COMPRIMIDO ? resto : BLOCO_COMPRIMIDO) - 1;
+    }
+
+    static inline void cursor_avancar(Cursor* c) {
+        if (c->restantes > 0) {
+            c->valor += ler_varint(&c->p);
+            c->restantes--;
+        } else if (c->bloco + 1 < c->num_blocos) {
+            cursor_entrar_bloco(c, c->bloco + 1);
+        } else {
+            c->fim = true;
+        }
+    }
+
+    // Avança até o primeiro vizinho >= x, pulando blocos inteiros pelo índice.
+    static inline void cursor_ate(Cursor* c, int x) {
+        if (c->fim || c->valor >= x) {
+            return;
+        }
+        if (c->bloco + 1 < c->num_blocos) {
+            const int* valores = c->a->valor_salto + c->a->primeiro_salto_de[c->v] - 1;
+            int lo = c->bloco + 1, hi = c->num_blocos - 1, destino = c->bloco;
+            while (lo <= hi) {
+                int meio = (lo + hi) >> 1;
+                if (valores[meio] <= x) {
+                    destino = meio;
+                    lo = meio + 1;
+                } else {
+                    hi = meio - 1;
+                }
+            }
+            if (destino != c->bloco) {
+                cursor_entrar_bloco(c, destino);
+            }
+        }
+        while (!c->fim && c->valor < x) {
+            cursor_avancar(c);
+        }
+    }
+
+    void cursor_abrir(Cursor* c, const AdjacenciaComprimida* a, int v, int x) {
+        c->a = a;
+        c->v = v;
+        c->num_blocos = (a->grau[v] + BLOCO_COMPRIMIDO - 1) / BLOCO_COMPRIMIDO;
+        c->fim = a->grau[v] == 0;
+        if (!c->fim) {
+            cursor_entrar_bloco(c, 0);
+            cursor_ate(c, x);
+        }
+    }
+
+    // Interseção em fluxo: percorre os vizinhos do último vértice acima dele e
+    // avança, em conjunto, um cursor por membro da clique.
+    void expandir_clique_comprimida(const AdjacenciaComprimida* a, Lista* clique_atual, Lista** pilha) {
+        int tamanho = clique_atual->tamanho;
+        int* vertices = clique_atual->vertices;
+        int ultimo = vertices[tamanho - 1];
+        INSTR(contar_quadro(tamanho));
+        Cursor candidatos;
+        cursor_abrir(&candidatos, a, ultimo, ultimo + 1);
+        if (candidatos.fim) {
+            return;
+        }
+        Cursor outros[tamanho];
+        for (int i = 0; i < tamanho - 1; i++) {
+            cursor_abrir(&outros[i], a, vertices[i], candidatos.valor);
+        }
+        while (!candidatos.fim) {
+            int x = candidatos.valor;
+            bool conectado = true;
+            INSTR(instr()->candidatos++);
+            for (int i = 0; i < tamanho - 1; i++) {
+                INSTR(instr()->sondagens++);
+                cursor_ate(&outros[i], x);
+                if (outros[i].fim) {
+                    return;
+                }
+                if (outros[i].valor != x) {
+                    conectado = false;
+                    break;
+                }
+            }
+            if (conectado) {
+                int nova_clique[tamanho + 1];
+                memcpy(nova_clique, vertices, tamanho * sizeof(int));
+                nova_clique[tamanho] = x;
+                empilhar(pilha, nova_clique, tamanho + 1);
+            }
+            cursor_avancar(&candidatos);
+        }
+    }
+
+    // Empilha as extensões de "clique_atual": candidatos vêm da lista do último
+    // vértice (vizinhos de ID maior) e são testados contra os demais membros.
+    void expandir_clique(Grafo* g, Lista* clique_atual, Lista** pilha) {
+        if (g->comprimida != NULL) {
+            expandir_clique_comprimida(g->comprimida, clique_atual, pilha);
+            return;
+        }
+        int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
+
+        int num_candidatos;
+        const int* candidatos = candidatos_apos(g, ultimo_vertice, &num_candidatos);
+        INSTR(contar_quadro(clique_atual->tamanho));
+        INSTR(instr()->candidatos += num_candidatos);
+        for (int c = 0; c < num_candidatos; c++) {
+            int vizinho = candidatos[c];
+            if (!contem(clique_atual->vertices, clique_atual->tamanho, vizinho) 
+                && conexao_completa(g, clique_atual->vertices, clique_atual->tamanho - 1, vizinho)) {
+                int nova_clique[clique_atual->tamanho + 1];
+                for (int j = 0; j < clique_atual->tamanho; j++) {
+                    nova_clique[j] = clique_atual->vertices[j];
+                }
+                nova_clique[clique_atual->tamanho] = vizinho;
+                empilhar(pilha, nova_clique, clique_atual->tamanho + 1);
+            }
+        }
+    }
+
+    // Quadros (cliques parciais) expandidos na última contagem.
+    long long quadros_expandidos = 0;
+
+    // O OpenMP mantém uma cópia privada de "contador" por thread (reduction)
+    // e soma as cópias uma vez no fim da região.
+    contagem_t contagem_de_cliques_serial(Grafo* g, int k, char* schedule, int num_threads, FILE* saida, Reordenacao* r) {
         Lista* cliques = NULL;
-        int contador = 0;
+        contagem_t contador = 0;
+        long long quadros = 0;
 
         for (int v = 0; v < g->V; v++) {
             int clique_inicial[] = {v};
@@ -127,39 +623,32 @@
         }
 
         if (strcmp(schedule, "serial") == 0) {
+            INSTR(double inicio_raiz = omp_get_wtime());
             while (cliques != NULL) {
                 Lista* clique_atual = desempilhar(&cliques);
 
                 if (clique_atual->tamanho == k) {
                     contador++;
+                    registrar_clique(saida, r, clique_atual->vertices, k);
                     free(clique_atual->vertices);
                     free(clique_atual);
                     continue;
                 }
 
-                int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
-
-                for (int vizinho = ultimo_vertice + 1; vizinho < g->V; vizinho++) {
-                    if (!contem(clique_atual->vertices, clique_atual->tamanho, vizinho) 
-                        && conexao_completa(g, clique_atual->vertices, clique_atual->tamanho, vizinho)) {
-                        int nova_clique[clique_atual->tamanho + 1];
-                        for (int j = 0; j < clique_atual->tamanho; j++) {
-                            nova_clique[j] = clique_atual->vertices[j];
-                        }
-                        nova_clique[clique_atual->tamanho] = vizinho;
-                        empilhar(&cliques, nova_clique, clique_atual->tamanho + 1);
-                    }
-                }
+                quadros++;
+                expandir_clique(g, clique_atual, &cliques);
 
                 free(clique_atual->vertices);
                 free(clique_atual);
             }
+            INSTR(registrar_ocupado(inicio_raiz));
 
         } 
         else if (strcmp(schedule, "static") == 0) {
-            omp_set_num_threads(8); 
-            #pragma omp parallel for schedule(static) reduction(+:contador)
+            omp_set_num_threads(num_threads); 
+            #pragma omp parallel for schedule(static) reduction(+:contador,quadros)
             for (int v = 0; v < g->V; v++) {
+                INSTR(double inicio_raiz = omp_get_wtime());
                 Lista* local_cliques = NULL;
                 int clique_inicial[] = {v};
                 empilhar(&local_cliques, clique_inicial, 1);
@@ -169,35 +658,27 @@
 
                     if (clique_atual->tamanho == k) {
                         contador++;
+                        registrar_clique(saida, r, clique_atual->vertices, k);
                         free(clique_atual->vertices);
                         free(clique_atual);
                         continue;
                     }
 
-                    int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
-
-                    for (int vizinho = ultimo_vertice + 1; vizinho < g->V; vizinho++) {
-                        if (!contem(clique_atual->vertices, clique_atual->tamanho, vizinho) 
-                            && conexao_completa(g, clique_atual->vertices, clique_atual->tamanho, vizinho)) {
-                            int nova_clique[clique_atual->tamanho + 1];
-                            for (int j = 0; j < clique_atual->tamanho; j++) {
-                                nova_clique[j] = clique_atual->vertices[j];
-                            }
-                            nova_clique[clique_atual->tamanho] = vizinho;
-                            empilhar(&local_cliques, nova_clique, clique_atual->tamanho + 1);
-                        }
-                    }
+                    quadros++;
+                    expandir_clique(g, clique_atual, &local_cliques);
 
                     free(clique_atual->vertices);
                     free(clique_atual);
                 }
+                INSTR(registrar_ocupado(inicio_raiz));
             }
         }
 
         else if (strcmp(schedule, "dynamic") == 0) {
-            omp_set_num_threads(8); 
-            #pragma omp parallel for schedule(dynamic) reduction(+:contador)
+            omp_set_num_threads(num_threads); 
+            #pragma omp parallel for schedule(dynamic) reduction(+:contador,quadros)
             for (int v = 0; v < g->V; v++) {
+                INSTR(double inicio_raiz = omp_get_wtime());
                 Lista* local_cliques = NULL;
                 int clique_inicial[] = {v};
                 empilhar(&local_cliques, clique_inicial, 1);
@@ -207,34 +688,26 @@
 
                     if (clique_atual->tamanho == k) {
                         contador++;
+                        registrar_clique(saida, r, clique_atual->vertices, k);
                         free(clique_atual->vertices);
                         free(clique_atual);
                         continue;
                     }
 
-                    int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
-
-                    for (int vizinho = ultimo_vertice + 1; vizinho < g->V; vizinho++) {
-                        if (!contem(clique_atual->vertices, clique_atual->tamanho, vizinho) 
-                            && conexao_completa(g, clique_atual->vertices, clique_atual->tamanho, vizinho)) {
-                            int nova_clique[clique_atual->tamanho + 1];
-                            for (int j = 0; j < clique_atual->tamanho; j++) {
-                                nova_clique[j] = clique_atual->vertices[j];
-                            }
-                            nova_clique[clique_atual->tamanho] = vizinho;
-                            empilhar(&local_cliques, nova_clique, clique_atual->tamanho + 1);
-                        }
-                    }
+                    quadros++;
+                    expandir_clique(g, clique_atual, &local_cliques);
 
                     free(clique_atual->vertices);
                     free(clique_atual);
                 }
+                INSTR(registrar_ocupado(inicio_raiz));
             }
         }
         else if (strcmp(schedule, "guided") == 0) {
-            omp_set_num_threads(8); 
-            #pragma omp parallel for schedule(guided) reduction(+:contador)
+            omp_set_num_threads(num_threads); 
+            #pragma omp parallel for schedule(guided) reduction(+:contador,quadros)
             for (int v = 0; v < g->V; v++) {
+                INSTR(double inicio_raiz = omp_get_wtime());
                 Lista* local_cliques = NULL;
                 int clique_inicial[] = {v};
                 empilhar(&local_cliques, clique_inicial, 1);
@@ -244,88 +717,1816 @@
 
                     if (clique_atual->tamanho == k) {
                         contador++;
+                        registrar_clique(saida, r, clique_atual->vertices, k);
                         free(clique_atual->vertices);
                         free(clique_atual);
                         continue;
                     }
 
-                    int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
-
-                    for (int vizinho = ultimo_vertice + 1; vizinho < g->V; vizinho++) {
-                        if (!contem(clique_atual->vertices, clique_atual->tamanho, vizinho) 
-                            && conexao_completa(g, clique_atual->vertices, clique_atual->tamanho, vizinho)) {
-                            int nova_clique[clique_atual->tamanho + 1];
-                            for (int j = 0; j < clique_atual->tamanho; j++) {
-                                nova_clique[j] = clique_atual->vertices[j];
-                            }
-                            nova_clique[clique_atual->tamanho] = vizinho;
-                            empilhar(&local_cliques, nova_clique, clique_atual->tamanho + 1);
-                        }
-                    }
+                    quadros++;
+                    expandir_clique(g, clique_atual, &local_cliques);
 
                     free(clique_atual->vertices);
                     free(clique_atual);
                 }
+                INSTR(registrar_ocupado(inicio_raiz));
             }
         }
+        quadros_expandidos = quadros;
         return contador;
     }
 
-    void liberar_grafo(Grafo* g) {
-        for (int i = 0; i < g->V; i++) {
-            Nodo* nodo_atual = g->adj[i];
-            while (nodo_atual != NULL) {
-                Nodo* prox = nodo_atual->prox;
-                free(nodo_atual);
-                nodo_atual = prox;
+    // Checkpoint da contagem (--checkpoint=arquivo): a unidade de trabalho é a
+    // raiz, então basta guardar quais raízes terminaram (um bit por vértice, em
+    // IDs do arquivo de entrada) e a soma das cliques delas. A ordem dos
+    // vértices decide qual raiz conta cada clique, então a retomada exige a
+    // mesma --ordem. O arquivo é uma linha de cabeçalho seguida do bitmap e é
+    // gravado num temporário que substitui o anterior com rename, de modo que
+    // uma interrupção no meio da gravação deixa o checkpoint antigo intacto.
+    typedef struct Checkpoint {
+        const char* arquivo;
+        const char* dataset;
+        const char* ordem;
+        int k;
+        int V;
+        uint8_t* concluidas;
+        int num_concluidas;
+        contagem_t parcial;
+        double intervalo;
+        double ultima_gravacao;
+        int gravacoes;
+        double tempo_gravacao;
+        size_t bytes;
+    } Checkpoint;
+
+    contagem_t ler_contagem(const char* texto) {
+        contagem_t c = 0;
+        for (; *texto >= '0' && *texto <= '9'; texto++) {
+            c = c * 10 + (contagem_t)(*texto - '0');
+        }
+        return c;
+    }
+
+    static inline bool raiz_concluida(Checkpoint* c, int v) {
+        return (c->concluidas[v >> 3] >> (v & 7)) & 1;
+    }
+
+    bool gravar_checkpoint(Checkpoint* c) {
+        double inicio = omp_get_wtime();
+        char temporario[300];
+        snprintf(temporario, sizeof(temporario), "%s.tmp", c->arquivo);
+        FILE* f = fopen(temporario, "wb");
+        if (f == NULL) {
+            fprintf(stderr, "Erro ao criar %s\n", temporario);
+            return false;
+        }
+        char texto[48];
+        size_t tamanho_bitmap = ((size_t)c->V + 7) / 8;
+        int cabecalho = fprintf(f, "KCLIQUE-CHECKPOINT %s %s %d %d %d %s\n", c->dataset, c->ordem, c->k,
+                                c->V, c->num_concluidas, formatar_contagem(c->parcial, texto));
+        bool ok = cabecalho > 0 && fwrite(c->concluidas, 1, tamanho_bitmap, f) == tamanho_bitmap;
+        ok = fflush(f) == 0 && ok;
+        ok = fsync(fileno(f)) == 0 && ok;
+        ok = fclose(f) == 0 && ok;
+        if (!ok || rename(temporario, c->arquivo) != 0) {
+            fprintf(stderr, "Erro ao gravar o checkpoint %s\n", c->arquivo);
+            unlink(temporario);
+            return false;
+        }
+        c->gravacoes++;
+        c->bytes += cabecalho + tamanho_bitmap;
+        c->ultima_gravacao = omp_get_wtime();
+        c->tempo_gravacao += c->ultima_gravacao - inicio;
+        return true;
+    }
+
+    // Prepara o checkpoint; se "arquivo" já existe e é da mesma contagem
+    // (dataset, ordem, k e número de vértices), retoma dele.
+    Checkpoint* abrir_checkpoint(const char* arquivo, const char* dataset, const char* ordem, int k, int V,
+                                 double intervalo) {
+        Checkpoint* c = (Checkpoint*)calloc(1, sizeof(Checkpoint));
+        c->arquivo = arquivo;
+        c->dataset = dataset;
+        c->ordem = ordem;
+        c->k = k;
+        c->V = V;
+        c->intervalo = intervalo;
+        c->concluidas = (uint8_t*)calloc(((size_t)V + 7) / 8, 1);
+        c->ultima_gravacao = omp_get_wtime();
+
+        FILE* f = fopen(arquivo, "rb");
+        if (f == NULL) {
+            return c;
+        }
+        char nome[110], ordem_arquivo[32], texto[48];
+        int k_arquivo, V_arquivo, num_concluidas;
+        if (fscanf(f, "KCLIQUE-CHECKPOINT %109s %31s %d %d %d %47s", nome, ordem_arquivo, &k_arquivo,
+                   &V_arquivo, &num_concluidas, texto) != 6 || fgetc(f) != '\n') {
+            fprintf(stderr, "Checkpoint inválido: %s\n", arquivo);
+            exit(EXIT_FAILURE);
+        }
+        if (strcmp(nome, dataset) != 0 || strcmp(ordem_arquivo, ordem) != 0 || k_arquivo != k || V_arquivo != V) {
+            fprintf(stderr, "Checkpoint %s é de outra contagem (%s, ordem %s, k = %d, %d vértices)\n",
+                    arquivo, nome, ordem_arquivo, k_arquivo, V_arquivo);
+            exit(EXIT_FAILURE);
+        }
+        size_t tamanho_bitmap = ((size_t)V + 7) / 8;
+        if (fread(c->concluidas, 1, tamanho_bitmap, f) != tamanho_bitmap) {
+            fprintf(stderr, "Checkpoint truncado: %s\n", arquivo);
+            exit(EXIT_FAILURE);
+        }
+        fclose(f);
+        c->num_concluidas = num_concluidas;
+        c->parcial = ler_contagem(texto);
+        printf("Retomando de %s: %d de %d raízes concluídas, %s cliques\n",
+               arquivo, num_concluidas, V, texto);
+        return c;
+    }
+
+    void liberar_checkpoint(Checkpoint* c) {
+        if (c != NULL) {
+            free(c->concluidas);
+            free(c);
+        }
+    }
+
+    // Cliques com a raiz "v" (a mesma busca dos laços acima, para uma raiz só).
+    contagem_t contar_raiz(Grafo* g, int k, int v, FILE* saida, Reordenacao* r, long long* quadros) {
+        contagem_t contador = 0;
+        Lista* local_cliques = NULL;
+        int clique_inicial[] = {v};
+        empilhar(&local_cliques, clique_inicial, 1);
+
+        while (local_cliques != NULL) {
+            Lista* clique_atual = desempilhar(&local_cliques);
+
+            if (clique_atual->tamanho == k) {
+                contador++;
+                registrar_clique(saida, r, clique_atual->vertices, k);
+                free(clique_atual->vertices);
+                free(clique_atual);
+                continue;
             }
+
+            (*quadros)++;
+            expandir_clique(g, clique_atual, &local_cliques);
+
+            free(clique_atual->vertices);
+            free(clique_atual);
         }
-        free(g->adj);
-        free(g);
+        return contador;
     }
 
-    int main(int argc, char *argv[]) {
-        if (argc < 3) {
-            fprintf(stderr, "Uso: <schedule> <dataset> <k>\n");
-            return 1;
+    // Contagem com checkpoint: só as raízes ainda não concluídas são
+    // distribuídas (com o schedule pedido, sobre o número atual de threads).
+    // Cada raiz terminada entra no bitmap e na soma parcial numa seção crítica,
+    // e a thread que a fecha grava o checkpoint se o intervalo já passou.
+    contagem_t contagem_com_checkpoint(Grafo* g, int k, char* schedule, int num_threads, FILE* saida,
+                                       Reordenacao* r, Checkpoint* c) {
+        int* pendentes = (int*)malloc((g->V > 0 ? g->V : 1) * sizeof(int));
+        int num_pendentes = 0;
+        for (int v = 0; v < g->V; v++) {
+            if (!raiz_concluida(c, id_original(r, v))) {
+                pendentes[num_pendentes++] = v;
+            }
         }
 
-        char* schedule = argv[1];
-        char* dataset = argv[2];
-        int k = atoi(argv[3]);
-        
-        struct timespec start_time, end_time;
-        
-        int num_vertices;
-        if (strcmp(dataset, "citeseer") == 0) {
-            num_vertices = 3312;
-        } else if (strcmp(dataset, "ca_astroph") == 0) {
-            num_vertices = 18772;
-        } else if (strcmp(dataset, "dblp") == 0) {
-            num_vertices = 317080;
-        } else {
-            fprintf(stderr, "Dataset desconhecido: %s\n", dataset);
-            return 1;
+        omp_sched_t tipo = omp_sched_static;
+        if (strcmp(schedule, "dynamic") == 0) {
+            tipo = omp_sched_dynamic;
+        } else if (strcmp(schedule, "guided") == 0) {
+            tipo = omp_sched_guided;
         }
+        omp_set_schedule(tipo, 0);
+        omp_set_num_threads(strcmp(schedule, "serial") == 0 ? 1 : num_threads);
 
-        Grafo* g = criar_grafo(num_vertices);
+        long long quadros = 0;
+        #pragma omp parallel for schedule(runtime) reduction(+:quadros)
+        for (int i = 0; i < num_pendentes; i++) {
+            INSTR(double inicio_raiz = omp_get_wtime());
+            int v = pendentes[i];
+            contagem_t local = contar_raiz(g, k, v, saida, r, &quadros);
+            INSTR(registrar_ocupado(inicio_raiz));
 
-        char arquivo[110];
-        snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+            #pragma omp critical(checkpoint)
+            {
+                int original = id_original(r, v);
+                c->concluidas[original >> 3] |= (uint8_t)(1 << (original & 7));
+                c->num_concluidas++;
+                c->parcial += local;
+                if (omp_get_wtime() - c->ultima_gravacao >= c->intervalo) {
+                    gravar_checkpoint(c);
+                }
+            }
+        }
+        free(pendentes);
+        quadros_expandidos = quadros;
+        return c->parcial;
+    }
 
-        carregar_grafo_de_arquivo(g, arquivo);
+    int comparar_int(const void* a, const void* b) {
+        int x = *(const int*)a;
+        int y = *(const int*)b;
+        return (x > y) - (x < y);
+    }
 
-        clock_gettime(CLOCK_MONOTONIC, &start_time);
-        int resultado = contagem_de_cliques_serial(g, k, schedule);
+    ConjuntoHash* criar_hash(const int* chaves, int n) {
+        int capacidade = 16;
+        while (capacidade < 2 * n) {
+            capacidade <<= 1;
+        }
+        ConjuntoHash* h = (ConjuntoHash*)malloc(sizeof(ConjuntoHash));
+        h->chaves = (int*)malloc(capacidade * sizeof(int));
+        h->mascara = capacidade - 1;
+        memset(h->chaves, -1, capacidade * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            uint32_t j = espalhar(chaves[i]) & h->mascara;
+            while (h->chaves[j] != -1) {
+                j = (j + 1) & h->mascara;
+            }
+            h->chaves[j] = chaves[i];
+        }
+        return h;
+    }
 
-        clock_gettime(CLOCK_MONOTONIC, &end_time);
-        
-        double time_spent = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+    // Aloca um vetor grande do grafo. Com "paginas_grandes", alinha em 2 MB e
+    // pede páginas enormes transparentes (THP) para reduzir falhas de TLB.
+    void* alocar_grande(size_t bytes, bool paginas_grandes) {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (!paginas_grandes) {
+            return malloc(bytes);
+        }
+        size_t alinhamento = 2 * 1024 * 1024;
+        size_t tamanho = (bytes + alinhamento - 1) / alinhamento * alinhamento;
+        void* p = NULL;
+        if (posix_memalign(&p, alinhamento, tamanho) != 0) {
+            return malloc(bytes);
+        }
+    #ifdef MADV_HUGEPAGE
+        madvise(p, tamanho, MADV_HUGEPAGE);
+    #endif
+        return p;
+    }
 
-        printf("Tempo de execução: %.6f segundos\n", time_spent);
+    // Monta o índice a partir das listas encadeadas: ordena, remove arestas
+    // repetidas e laços, e cria o conjunto dos vértices com grau >= limiar.
+    // Para hubs, usa bitmap quando ele ocupa no máximo o mesmo que o hash.
+    // As listas ficam num único vetor preenchido pelas próprias threads de
+    // trabalho (schedule static), de modo que a primeira escrita de cada página
+    // aconteça no nó NUMA da thread que depois percorre aqueles vértices.
+    IndiceAdjacencia* construir_indice(Grafo* g, int limiar, int num_threads, bool paginas_grandes) {
+        int V = g->V;
+        IndiceAdjacencia* ind = (IndiceAdjacencia*)calloc(1, sizeof(IndiceAdjacencia));
+        ind->limiar = limiar;
+        ind->grau = (int*)malloc(V * sizeof(int));
+        ind->vizinhos = (int**)malloc(V * sizeof(int*));
+        ind->hashes = (ConjuntoHash**)calloc(V, sizeof(ConjuntoHash*));
+        ind->bitmaps = (uint64_t**)calloc(V, sizeof(uint64_t*));
+        ind->base_bitmap = (int*)calloc(V, sizeof(int));
+        ind->fim_bitmap = (int*)calloc(V, sizeof(int));
+
+        int64_t* inicio = (int64_t*)malloc((V + 1) * sizeof(int64_t));
+        inicio[0] = 0;
+        for (int v = 0; v < V; v++) {
+            int n = 0;
+            for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+                n++;
+            }
+            inicio[v + 1] = inicio[v] + n;
+        }
+        ind->arestas = (int*)alocar_grande(inicio[V] * sizeof(int), paginas_grandes);
+
+        int num_hubs = 0, num_bitmaps = 0;
+        size_t bytes_listas = 0, bytes_hubs = 0;
+        omp_set_num_threads(num_threads);
+        #pragma omp parallel for schedule(static) reduction(+:num_hubs,num_bitmaps,bytes_listas,bytes_hubs)
+        for (int v = 0; v < V; v++) {
+            int* lista = ind->arestas + inicio[v];
+            int n = 0;
+            for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+                if (adj->vertice != v) {
+                    lista[n++] = adj->vertice;
+                }
+            }
+            qsort(lista, n, sizeof(int), comparar_int);
+            int unicos = 0;
+            for (int i = 0; i < n; i++) {
+                if (unicos == 0 || lista[unicos - 1] != lista[i]) {
+                    lista[unicos++] = lista[i];
+                }
+            }
+            ind->grau[v] = unicos;
+            ind->vizinhos[v] = lista;
+            bytes_listas += unicos * sizeof(int);
+
+            if (unicos >= limiar && unicos > 0) {
+                num_hubs++;
+                size_t faixa = (size_t)(lista[unicos - 1] - lista[0]) + 1;
+                size_t bytes_bitmap = ((faixa + 63) / 64) * sizeof(uint64_t);
+                ConjuntoHash* h = criar_hash(lista, unicos);
+                size_t bytes_hash = (h->mascara + 1) * sizeof(int);
+                if (bytes_bitmap <= bytes_hash) {
+                    free(h->chaves);
+                    free(h);
+                    uint64_t* bits = (uint64_t*)calloc((faixa + 63) / 64, sizeof(uint64_t));
+                    for (int i = 0; i < unicos; i++) {
+                        int bit = lista[i] - lista[0];
+                        bits[bit >> 6] |= (uint64_t)1 << (bit & 63);
+                    }
+                    ind->bitmaps[v] = bits;
+                    ind->base_bitmap[v] = lista[0];
+                    ind->fim_bitmap[v] = lista[unicos - 1];
+                    num_bitmaps++;
+                    bytes_hubs += bytes_bitmap;
+                } else {
+                    ind->hashes[v] = h;
+                    bytes_hubs += bytes_hash;
+                }
+            }
+        }
+        free(inicio);
+        ind->num_hubs = num_hubs;
+        ind->num_bitmaps = num_bitmaps;
+        ind->bytes_listas = bytes_listas;
+        ind->bytes_hubs = bytes_hubs;
+        return ind;
+    }
+
+    void liberar_indice(IndiceAdjacencia* ind, int V) {
+        if (ind == NULL) {
+            return;
+        }
+        free(ind->arestas);
+        for (int v = 0; v < V; v++) {
+            if (ind->hashes[v] != NULL) {
+                free(ind->hashes[v]->chaves);
+                free(ind->hashes[v]);
+            }
+            free(ind->bitmaps[v]);
+        }
+        free(ind->grau);
+        free(ind->vizinhos);
+        free(ind->hashes);
+        free(ind->bitmaps);
+        free(ind->base_bitmap);
+        free(ind->fim_bitmap);
+        free(ind);
+    }
+
+    static size_t escrever_varint(uint8_t* p, uint32_t x) {
+        size_t n = 0;
+        while (x >= 0x80) {
+            p[n++] = (uint8_t)(x | 0x80);
+            x >>= 7;
+        }
+        p[n++] = (uint8_t)x;
+        return n;
+    }
+
+    AdjacenciaComprimida* comprimir_adjacencia(IndiceAdjacencia* ind, int V) {
+        AdjacenciaComprimida* a = (AdjacenciaComprimida*)calloc(1, sizeof(AdjacenciaComprimida));
+        a->V = V;
+        a->grau = (int*)malloc(V * sizeof(int));
+        a->inicio = (uint64_t*)malloc((V + 1) * sizeof(uint64_t));
+        a->primeiro_salto_de = (int64_t*)malloc((V + 1) * sizeof(int64_t));
+        int64_t saltos = 0;
+        size_t capacidade = 0;
+        for (int v = 0; v < V; v++) {
+            int blocos = (ind->grau[v] + BLOCO_COMPRIMIDO - 1) / BLOCO_COMPRIMIDO;
+            a->grau[v] = ind->grau[v];
+            a->primeiro_salto_de[v] = saltos;
+            saltos += blocos > 1 ? blocos - 1 : 0;
+            capacidade += (size_t)ind->grau[v] * 5;
+        }
+        a->primeiro_salto_de[V] = saltos;
+        a->valor_salto = (int*)malloc((saltos > 0 ? saltos : 1) * sizeof(int));
+        a->deslocamento_salto = (uint32_t*)malloc((saltos > 0 ? saltos : 1) * sizeof(uint32_t));
+        a->dados = (uint8_t*)malloc(capacidade > 0 ? capacidade : 1);
+
+        size_t pos = 0;
+        for (int v = 0; v < V; v++) {
+            const int* lista = ind->vizinhos[v];
+            a->inicio[v] = pos;
+            for (int i = 0; i < ind->grau[v]; i++) {
+                if (i == 0) {
+                    pos += escrever_varint(a->dados + pos, (uint32_t)lista[0]);
+                } else if (i % BLOCO_COMPRIMIDO == 0) {
+                    int64_t salto = a->primeiro_salto_de[v] + i / BLOCO_COMPRIMIDO - 1;
+                    a->valor_salto[salto] = lista[i];
+                    a->deslocamento_salto[salto] = (uint32_t)(pos - a->inicio[v]);
+                } else {
+                    pos += escrever_varint(a->dados + pos, (uint32_t)(lista[i] - lista[i - 1]));
+                }
+            }
+        }
+        a->inicio[V] = pos;
+        a->dados = (uint8_t*)realloc(a->dados, pos > 0 ? pos : 1);
+        a->bytes_dados = pos;
+        a->bytes_indice = saltos * (sizeof(int) + sizeof(uint32_t))
+                        + (V + 1) * (sizeof(uint64_t) + sizeof(int64_t)) + V * sizeof(int);
+        return a;
+    }
+
+    void liberar_comprimida(AdjacenciaComprimida* a) {
+        if (a == NULL) {
+            return;
+        }
+        free(a->dados);
+        free(a->inicio);
+        free(a->grau);
+        free(a->primeiro_salto_de);
+        free(a->valor_salto);
+        free(a->deslocamento_salto);
+        free(a);
+    }
+
+    // Percorre todas as listas nos dois formatos e imprime a vazão e o espaço
+    // de cada um (listas encadeadas: 16 B por aresta + ~16 B de cabeçalho do malloc).
+    void comparar_formatos(IndiceAdjacencia* ind, AdjacenciaComprimida* a, int V) {
+        struct timespec t0, t1;
+        size_t arestas = 0;
+        for (int v = 0; v < V; v++) {
+            arestas += ind->grau[v];
+        }
 
-        printf("Número de cliques de tamanho %d: %d\n", k, resultado);
+        volatile long soma_vetores = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int v = 0; v < V; v++) {
+            long soma = 0;
+            for (int i = 0; i < ind->grau[v]; i++) {
+                soma += ind->vizinhos[v][i];
+            }
+            soma_vetores += soma;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double tempo_vetores = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+        volatile long soma_comprimida = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int v = 0; v < V; v++) {
+            long soma = 0;
+            Cursor c;
+            cursor_abrir(&c, a, v, 0);
+            while (!c.fim) {
+                soma += c.valor;
+                cursor_avancar(&c);
+            }
+            soma_comprimida += soma;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double tempo_comprimida = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+        if (soma_vetores != soma_comprimida) {
+            fprintf(stderr, "Erro: adjacência comprimida difere da original\n");
+            exit(EXIT_FAILURE);
+        }
 
+        double mb = 1048576.0;
+        size_t bytes_vetores = arestas * sizeof(int) + V * (sizeof(int*) + sizeof(int));
+        printf("Memória de adjacência: encadeada %.2f MB, vetores %.2f MB, comprimida %.2f MB (dados %.2f + índice %.2f, %.2f bits/aresta)\n",
+               arestas * 32 / mb, bytes_vetores / mb, (a->bytes_dados + a->bytes_indice) / mb,
+               a->bytes_dados / mb, a->bytes_indice / mb,
+               arestas > 0 ? 8.0 * (a->bytes_dados + a->bytes_indice) / arestas : 0.0);
+        printf("Vazão de varredura: vetores %.1f Marestas/s, comprimida %.1f Marestas/s\n",
+               tempo_vetores > 0 ? arestas / tempo_vetores / 1e6 : 0.0,
+               tempo_comprimida > 0 ? arestas / tempo_comprimida / 1e6 : 0.0);
+    }
+
+    void liberar_grafo(Grafo* g) {
+        liberar_indice(g->indice, g->V);
+        liberar_comprimida(g->comprimida);
+        for (int i = 0; i < g->V; i++) {
+            Nodo* nodo_atual = g->adj[i];
+            while (nodo_atual != NULL) {
+                Nodo* prox = nodo_atual->prox;
+                free(nodo_atual);
+                nodo_atual = prox;
+            }
+        }
+        free(g->adj);
+        free(g);
+    }
+
+    int grau_vertice(Grafo* g, int v) {
+        int grau = 0;
+        for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+            grau++;
+        }
+        return grau;
+    }
+
+    typedef struct ParGrau {
+        int grau;
+        int vertice;
+    } ParGrau;
+
+    int comparar_par_grau(const void* a, const void* b) {
+        const ParGrau* x = (const ParGrau*)a;
+        const ParGrau* y = (const ParGrau*)b;
+        if (x->grau != y->grau) {
+            return x->grau < y->grau ? -1 : 1;
+        }
+        return x->vertice - y->vertice;
+    }
+
+    // Ordem crescente de grau (counting sort, estável nos IDs).
+    void ordem_por_grau(Grafo* g, int* grau, int* ordem) {
+        int grau_max = 0;
+        for (int v = 0; v < g->V; v++) {
+            if (grau[v] > grau_max) {
+                grau_max = grau[v];
+            }
+        }
+        int* inicio = (int*)calloc(grau_max + 2, sizeof(int));
+        for (int v = 0; v < g->V; v++) {
+            inicio[grau[v] + 1]++;
+        }
+        for (int d = 1; d <= grau_max + 1; d++) {
+            inicio[d] += inicio[d - 1];
+        }
+        for (int v = 0; v < g->V; v++) {
+            ordem[inicio[grau[v]]++] = v;
+        }
+        free(inicio);
+    }
+
+    // Ordem de degenerescência (Matula-Beck): remove sempre o vértice de menor
+    // grau restante. Cada vértice fica com no máximo "degenerescência" vizinhos
+    // de ID maior, que são os únicos expandidos pela busca.
+    void ordem_por_degeneracia(Grafo* g, int* grau, int* ordem) {
+        int V = g->V;
+        int grau_max = 0;
+        for (int v = 0; v < V; v++) {
+            if (grau[v] > grau_max) {
+                grau_max = grau[v];
+            }
+        }
+        int* d = (int*)malloc(V * sizeof(int));
+        int* bin = (int*)calloc(grau_max + 1, sizeof(int));
+        int* pos = (int*)malloc(V * sizeof(int));
+        int* vert = (int*)malloc(V * sizeof(int));
+        for (int v = 0; v < V; v++) {
+            d[v] = grau[v];
+            bin[d[v]]++;
+        }
+        int inicio = 0;
+        for (int x = 0; x <= grau_max; x++) {
+            int n = bin[x];
+            bin[x] = inicio;
+            inicio += n;
+        }
+        for (int v = 0; v < V; v++) {
+            pos[v] = bin[d[v]];
+            vert[pos[v]] = v;
+            bin[d[v]]++;
+        }
+        for (int x = grau_max; x > 0; x--) {
+            bin[x] = bin[x - 1];
+        }
+        bin[0] = 0;
+        for (int i = 0; i < V; i++) {
+            int v = vert[i];
+            ordem[i] = v;
+            for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+                int u = adj->vertice;
+                if (d[u] > d[v]) {
+                    int du = d[u];
+                    int pu = pos[u];
+                    int pw = bin[du];
+                    int w = vert[pw];
+                    if (u != w) {
+                        pos[u] = pw;
+                        vert[pu] = w;
+                        pos[w] = pu;
+                        vert[pw] = u;
+                    }
+                    bin[du]++;
+                    d[u]--;
+                }
+            }
+        }
+        free(d);
+        free(bin);
+        free(pos);
+        free(vert);
+    }
+
+    // Busca em largura por componente. Com "por_grau", os vizinhos são visitados
+    // em ordem crescente de grau (Cuthill-McKee) e a raiz é o vértice de menor
+    // grau; sem ele, a raiz é o de maior grau e a ordem é a da lista.
+    void ordem_por_largura(Grafo* g, int* grau, int* ordem, bool por_grau) {
+        int V = g->V;
+        bool* visitado = (bool*)calloc(V, sizeof(bool));
+        int* candidatos = (int*)malloc(V * sizeof(int));
+        ParGrau* vizinhos = (ParGrau*)malloc(V * sizeof(ParGrau));
+        ordem_por_grau(g, grau, candidatos);
+
+        int fim = 0;
+        for (int c = 0; c < V; c++) {
+            int raiz = por_grau ? candidatos[c] : candidatos[V - 1 - c];
+            if (visitado[raiz]) {
+                continue;
+            }
+            visitado[raiz] = true;
+            int cabeca = fim;
+            ordem[fim++] = raiz;
+            while (cabeca < fim) {
+                int v = ordem[cabeca++];
+                int n = 0;
+                for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+                    if (!visitado[adj->vertice]) {
+                        visitado[adj->vertice] = true;
+                        vizinhos[n].grau = grau[adj->vertice];
+                        vizinhos[n].vertice = adj->vertice;
+                        n++;
+                    }
+                }
+                if (por_grau) {
+                    qsort(vizinhos, n, sizeof(ParGrau), comparar_par_grau);
+                }
+                for (int i = 0; i < n; i++) {
+                    ordem[fim++] = vizinhos[i].vertice;
+                }
+            }
+        }
+        free(visitado);
+        free(candidatos);
+        free(vizinhos);
+    }
+
+    // Calcula a ordem pedida ("grau", "degeneracia", "rcm" ou "bfs").
+    // Retorna NULL se o nome for desconhecido.
+    Reordenacao* calcular_reordenacao(Grafo* g, const char* nome) {
+        int V = g->V;
+        int* grau = (int*)malloc(V * sizeof(int));
+        for (int v = 0; v < V; v++) {
+            grau[v] = grau_vertice(g, v);
+        }
+        int* ordem = (int*)malloc(V * sizeof(int));
+
+        if (strcmp(nome, "grau") == 0) {
+            ordem_por_grau(g, grau, ordem);
+        } else if (strcmp(nome, "degeneracia") == 0) {
+            ordem_por_degeneracia(g, grau, ordem);
+        } else if (strcmp(nome, "rcm") == 0) {
+            ordem_por_largura(g, grau, ordem, true);
+            for (int i = 0, j = V - 1; i < j; i++, j--) {
+                int tmp = ordem[i];
+                ordem[i] = ordem[j];
+                ordem[j] = tmp;
+            }
+        } else if (strcmp(nome, "bfs") == 0) {
+            ordem_por_largura(g, grau, ordem, false);
+        } else {
+            free(grau);
+            free(ordem);
+            return NULL;
+        }
+        free(grau);
+
+        Reordenacao* r = (Reordenacao*)malloc(sizeof(Reordenacao));
+        r->novo_para_original = ordem;
+        r->original_para_novo = (int*)malloc(V * sizeof(int));
+        for (int i = 0; i < V; i++) {
+            r->original_para_novo[ordem[i]] = i;
+        }
+        return r;
+    }
+
+    // Constrói o grafo permutado. Os nodos são alocados na nova ordem para que
+    // as listas de vértices com IDs próximos fiquem próximas na memória.
+    Grafo* aplicar_reordenacao(Grafo* g, Reordenacao* r) {
+        Grafo* h = criar_grafo(g->V);
+        for (int i = g->V - 1; i >= 0; i--) {
+            int u = r->novo_para_original[i];
+            for (Nodo* adj = g->adj[u]; adj != NULL; adj = adj->prox) {
+                Nodo* novo_nodo = criar_nodo(r->original_para_novo[adj->vertice]);
+                novo_nodo->prox = h->adj[i];
+                h->adj[i] = novo_nodo;
+            }
+        }
+        return h;
+    }
+
+    void liberar_reordenacao(Reordenacao* r) {
+        if (r == NULL) {
+            return;
+        }
+        free(r->novo_para_original);
+        free(r->original_para_novo);
+        free(r);
+    }
+
+    // Modo incremental: a adjacência fica em listas ordenadas com folga, que
+    // aceitam inserção e remoção por memmove e continuam prontas para
+    // interseções. Cada lote de atualizações ajusta a contagem só com as cliques
+    // que passam pelas arestas alteradas.
+    typedef struct AdjacenciaDinamica {
+        int V;
+        int* grau;
+        int* capacidade;
+        int** vizinhos;
+    } AdjacenciaDinamica;
+
+    AdjacenciaDinamica* criar_adjacencia_dinamica(IndiceAdjacencia* ind, int V) {
+        AdjacenciaDinamica* d = (AdjacenciaDinamica*)malloc(sizeof(AdjacenciaDinamica));
+        d->V = V;
+        d->grau = (int*)malloc(V * sizeof(int));
+        d->capacidade = (int*)malloc(V * sizeof(int));
+        d->vizinhos = (int**)malloc(V * sizeof(int*));
+        for (int v = 0; v < V; v++) {
+            int n = ind->grau[v];
+            d->grau[v] = n;
+            d->capacidade[v] = n + n / 4 + 4;
+            d->vizinhos[v] = (int*)malloc(d->capacidade[v] * sizeof(int));
+            memcpy(d->vizinhos[v], ind->vizinhos[v], n * sizeof(int));
+        }
+        return d;
+    }
+
+    void liberar_adjacencia_dinamica(AdjacenciaDinamica* d) {
+        if (d == NULL) {
+            return;
+        }
+        for (int v = 0; v < d->V; v++) {
+            free(d->vizinhos[v]);
+        }
+        free(d->grau);
+        free(d->capacidade);
+        free(d->vizinhos);
+        free(d);
+    }
+
+    // Primeira posição da lista de "v" com vizinho >= x.
+    static int posicao_vizinho(AdjacenciaDinamica* d, int v, int x) {
+        const int* lista = d->vizinhos[v];
+        int lo = 0, hi = d->grau[v];
+        while (lo < hi) {
+            int meio = (lo + hi) >> 1;
+            if (lista[meio] < x) {
+                lo = meio + 1;
+            } else {
+                hi = meio;
+            }
+        }
+        return lo;
+    }
+
+    bool dinamica_contem(AdjacenciaDinamica* d, int u, int v) {
+        if (d->grau[u] <= d->grau[v]) {
+            return lista_contem(d->vizinhos[u], d->grau[u], v);
+        }
+        return lista_contem(d->vizinhos[v], d->grau[v], u);
+    }
+
+    bool inserir_vizinho(AdjacenciaDinamica* d, int v, int x) {
+        int p = posicao_vizinho(d, v, x);
+        if (p < d->grau[v] && d->vizinhos[v][p] == x) {
+            return false;
+        }
+        if (d->grau[v] == d->capacidade[v]) {
+            d->capacidade[v] *= 2;
+            d->vizinhos[v] = (int*)realloc(d->vizinhos[v], d->capacidade[v] * sizeof(int));
+        }
+        memmove(d->vizinhos[v] + p + 1, d->vizinhos[v] + p, (d->grau[v] - p) * sizeof(int));
+        d->vizinhos[v][p] = x;
+        d->grau[v]++;
+        return true;
+    }
+
+    bool remover_vizinho(AdjacenciaDinamica* d, int v, int x) {
+        int p = posicao_vizinho(d, v, x);
+        if (p == d->grau[v] || d->vizinhos[v][p] != x) {
+            return false;
+        }
+        memmove(d->vizinhos[v] + p, d->vizinhos[v] + p + 1, (d->grau[v] - p - 1) * sizeof(int));
+        d->grau[v]--;
+        return true;
+    }
+
+    typedef struct ArestaLote {
+        int u;
+        int v;
+        bool insercao;
+    } ArestaLote;
+
+    // Arestas de um lote -> posição no lote (endereçamento aberto).
+    typedef struct TabelaLote {
+        uint64_t* chaves;
+        int* indices;
+        int mascara;
+    } TabelaLote;
+
+    static inline uint64_t chave_aresta(int u, int v) {
+        if (u > v) {
+            int tmp = u;
+            u = v;
+            v = tmp;
+        }
+        return ((uint64_t)(uint32_t)u << 32) | (uint32_t)v;
+    }
+
+    static inline uint32_t espalhar_chave(uint64_t chave) {
+        return (uint32_t)((chave * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    TabelaLote* criar_tabela_lote(int n) {
+        int capacidade = 16;
+        while (capacidade < 2 * n) {
+            capacidade <<= 1;
+        }
+        TabelaLote* t = (TabelaLote*)malloc(sizeof(TabelaLote));
+        t->chaves = (uint64_t*)malloc(capacidade * sizeof(uint64_t));
+        t->indices = (int*)malloc(capacidade * sizeof(int));
+        t->mascara = capacidade - 1;
+        memset(t->chaves, 0xff, capacidade * sizeof(uint64_t));
+        return t;
+    }
+
+    // Devolve false se a aresta já estava na tabela.
+    bool tabela_inserir(TabelaLote* t, int u, int v, int indice) {
+        uint64_t chave = chave_aresta(u, v);
+        uint32_t i = espalhar_chave(chave) & t->mascara;
+        while (t->chaves[i] != UINT64_MAX) {
+            if (t->chaves[i] == chave) {
+                return false;
+            }
+            i = (i + 1) & t->mascara;
+        }
+        t->chaves[i] = chave;
+        t->indices[i] = indice;
+        return true;
+    }
+
+    int tabela_indice(TabelaLote* t, int u, int v) {
+        uint64_t chave = chave_aresta(u, v);
+        uint32_t i = espalhar_chave(chave) & t->mascara;
+        while (t->chaves[i] != UINT64_MAX) {
+            if (t->chaves[i] == chave) {
+                return t->indices[i];
+            }
+            i = (i + 1) & t->mascara;
+        }
+        return -1;
+    }
+
+    void liberar_tabela_lote(TabelaLote* t) {
+        free(t->chaves);
+        free(t->indices);
+        free(t);
+    }
+
+    // A aresta (u, v) está no lote antes da posição "limite"?
+    static inline bool aresta_anterior(TabelaLote* lote, int u, int v, int limite) {
+        if (lote == NULL) {
+            return false;
+        }
+        int i = tabela_indice(lote, u, v);
+        return i >= 0 && i < limite;
+    }
+
+    // Conta as cliques de "restante" vértices tiradas de candidatos[0..n)
+    // (ordenados, todos ligados aos vértices já escolhidos), sem usar arestas do
+    // lote com posição menor que "limite".
+    contagem_t contar_extensoes(AdjacenciaDinamica* d, const int* candidatos, int n, int restante,
+                                TabelaLote* lote, int limite) {
+        if (restante == 0) {
+            return 1;
+        }
+        if (restante == 1) {
+            return n;
+        }
+        contagem_t total = 0;
+        int* proximos = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+        for (int i = 0; i + restante <= n; i++) {
+            int w = candidatos[i];
+            int m = 0;
+            for (int j = i + 1; j < n; j++) {
+                int x = candidatos[j];
+                if (dinamica_contem(d, w, x) && !aresta_anterior(lote, w, x, limite)) {
+                    proximos[m++] = x;
+                }
+            }
+            if (m >= restante - 1) {
+                total += contar_extensoes(d, proximos, m, restante - 1, lote, limite);
+            }
+        }
+        free(proximos);
+        return total;
+    }
+
+    // Cliques de tamanho k que contêm a aresta (u, v) e nenhuma aresta do lote
+    // anterior a ela: as (k-2)-cliques dentro de N(u) ∩ N(v). Com graus muito
+    // desiguais, a interseção busca a lista menor na maior; senão, intercala.
+    contagem_t cliques_pela_aresta(AdjacenciaDinamica* d, int u, int v, int k, TabelaLote* lote, int posicao) {
+        if (k < 2) {
+            return 0;
+        }
+        if (k == 2) {
+            return 1;
+        }
+        if (d->grau[u] > d->grau[v]) {
+            int tmp = u;
+            u = v;
+            v = tmp;
+        }
+        const int* a = d->vizinhos[u];
+        const int* b = d->vizinhos[v];
+        int na = d->grau[u], nb = d->grau[v];
+        int* comuns = (int*)malloc((na > 0 ? na : 1) * sizeof(int));
+        int m = 0;
+        if ((int64_t)na * 16 < nb) {
+            for (int i = 0; i < na; i++) {
+                if (lista_contem(b, nb, a[i])) {
+                    comuns[m++] = a[i];
+                }
+            }
+        } else {
+            for (int i = 0, j = 0; i < na && j < nb;) {
+                if (a[i] < b[j]) {
+                    i++;
+                } else if (a[i] > b[j]) {
+                    j++;
+                } else {
+                    comuns[m++] = a[i];
+                    i++;
+                    j++;
+                }
+            }
+        }
+        int filtrados = 0;
+        for (int i = 0; i < m; i++) {
+            int w = comuns[i];
+            if (!aresta_anterior(lote, u, w, posicao) && !aresta_anterior(lote, v, w, posicao)) {
+                comuns[filtrados++] = w;
+            }
+        }
+        contagem_t total = contar_extensoes(d, comuns, filtrados, k - 2, lote, posicao);
+        free(comuns);
+        return total;
+    }
+
+    // Cliques ganhas (ou perdidas) com as arestas do lote, em paralelo. Cada
+    // clique é atribuída à aresta alterada de menor posição que ela contém, então
+    // arestas do mesmo lote não contam a mesma clique duas vezes.
+    contagem_t variacao_do_lote(AdjacenciaDinamica* d, ArestaLote* arestas, int n, int k, int num_threads) {
+        TabelaLote* lote = criar_tabela_lote(n);
+        for (int i = 0; i < n; i++) {
+            tabela_inserir(lote, arestas[i].u, arestas[i].v, i);
+        }
+        contagem_t total = 0;
+        omp_set_num_threads(num_threads);
+        #pragma omp parallel for schedule(dynamic) reduction(+:total)
+        for (int i = 0; i < n; i++) {
+            total += cliques_pela_aresta(d, arestas[i].u, arestas[i].v, k, lote, i);
+        }
+        liberar_tabela_lote(lote);
+        return total;
+    }
+
+    // Recontagem completa sobre a adjacência dinâmica (para --verificar).
+    contagem_t contar_dinamica(AdjacenciaDinamica* d, int k, int num_threads) {
+        if (k == 1) {
+            return d->V;
+        }
+        contagem_t total = 0;
+        omp_set_num_threads(num_threads);
+        #pragma omp parallel for schedule(dynamic) reduction(+:total)
+        for (int v = 0; v < d->V; v++) {
+            int p = posicao_vizinho(d, v, v + 1);
+            total += contar_extensoes(d, d->vizinhos[v] + p, d->grau[v] - p, k - 1, NULL, 0);
+        }
+        return total;
+    }
+
+    // Arquivo de atualizações: uma operação por linha, "+ u v" insere e "- u v"
+    // remove a aresta (IDs do arquivo de entrada); linha em branco fecha o lote.
+    // Dentro do lote vale a última operação de cada aresta, e as que não mudam o
+    // grafo são descartadas. Devolve false no fim do arquivo.
+    bool ler_lote(FILE* f, AdjacenciaDinamica* d, Reordenacao* r, ArestaLote** remocoes, int* num_remocoes,
+                  ArestaLote** insercoes, int* num_insercoes) {
+        int capacidade = 1024, n = 0;
+        ArestaLote* ops = (ArestaLote*)malloc(capacidade * sizeof(ArestaLote));
+        char linha[256];
+        while (fgets(linha, sizeof(linha), f) != NULL) {
+            char op;
+            int u, v;
+            if (sscanf(linha, " %c", &op) != 1) {
+                if (n > 0) {
+                    break;
+                }
+                continue;
+            }
+            if (op == '#') {
+                continue;
+            }
+            if ((op != '+' && op != '-') || sscanf(linha, " %*c %d %d", &u, &v) != 2) {
+                fprintf(stderr, "Linha de atualização inválida: %s", linha);
+                continue;
+            }
+            if (u < 0 || u >= d->V || v < 0 || v >= d->V || u == v) {
+                continue;
+            }
+            if (n == capacidade) {
+                capacidade *= 2;
+                ops = (ArestaLote*)realloc(ops, capacidade * sizeof(ArestaLote));
+            }
+            ops[n].u = r != NULL ? r->original_para_novo[u] : u;
+            ops[n].v = r != NULL ? r->original_para_novo[v] : v;
+            ops[n].insercao = op == '+';
+            n++;
+        }
+
+        *remocoes = (ArestaLote*)malloc((n > 0 ? n : 1) * sizeof(ArestaLote));
+        *insercoes = (ArestaLote*)malloc((n > 0 ? n : 1) * sizeof(ArestaLote));
+        *num_remocoes = 0;
+        *num_insercoes = 0;
+        TabelaLote* vistas = criar_tabela_lote(n);
+        for (int i = n - 1; i >= 0; i--) {
+            if (!tabela_inserir(vistas, ops[i].u, ops[i].v, i)) {
+                continue;
+            }
+            bool presente = dinamica_contem(d, ops[i].u, ops[i].v);
+            if (ops[i].insercao && !presente) {
+                (*insercoes)[(*num_insercoes)++] = ops[i];
+            } else if (!ops[i].insercao && presente) {
+                (*remocoes)[(*num_remocoes)++] = ops[i];
+            }
+        }
+        liberar_tabela_lote(vistas);
+        free(ops);
+        return n > 0;
+    }
+
+    // Consome os lotes de "arquivo" a partir da contagem base. As remoções são
+    // contadas no grafo que ainda tem todas elas e só então aplicadas; as
+    // inserções são aplicadas todas e contadas no grafo resultante.
+    contagem_t processar_atualizacoes(AdjacenciaDinamica* d, const char* arquivo, int k, int num_threads,
+                                      Reordenacao* r, contagem_t base, bool verificar) {
+        FILE* f = fopen(arquivo, "r");
+        if (f == NULL) {
+            fprintf(stderr, "Erro ao abrir %s\n", arquivo);
+            exit(EXIT_FAILURE);
+        }
+        contagem_t total = base;
+        int num_lotes = 0;
+        double tempo_total = 0;
+        ArestaLote* remocoes;
+        ArestaLote* insercoes;
+        int num_remocoes, num_insercoes;
+        while (ler_lote(f, d, r, &remocoes, &num_remocoes, &insercoes, &num_insercoes)) {
+            struct timespec inicio, fim;
+            clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+            contagem_t perdidas = variacao_do_lote(d, remocoes, num_remocoes, k, num_threads);
+            for (int i = 0; i < num_remocoes; i++) {
+                remover_vizinho(d, remocoes[i].u, remocoes[i].v);
+                remover_vizinho(d, remocoes[i].v, remocoes[i].u);
+            }
+            for (int i = 0; i < num_insercoes; i++) {
+                inserir_vizinho(d, insercoes[i].u, insercoes[i].v);
+                inserir_vizinho(d, insercoes[i].v, insercoes[i].u);
+            }
+            contagem_t ganhas = variacao_do_lote(d, insercoes, num_insercoes, k, num_threads);
+            total = total - perdidas + ganhas;
+
+            clock_gettime(CLOCK_MONOTONIC, &fim);
+            double tempo = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+            tempo_total += tempo;
+            num_lotes++;
+
+            char texto_ganhas[48], texto_perdidas[48], texto_total[48];
+            printf("Lote %d: %d inserções, %d remoções, +%s -%s cliques, total %s (%.6f segundos)\n",
+                   num_lotes, num_insercoes, num_remocoes, formatar_contagem(ganhas, texto_ganhas),
+                   formatar_contagem(perdidas, texto_perdidas), formatar_contagem(total, texto_total), tempo);
+            if (verificar) {
+                contagem_t esperado = contar_dinamica(d, k, num_threads);
+                char texto_esperado[48];
+                printf("  Verificação: %s (recontagem %s)\n", esperado == total ? "ok" : "DIVERGENTE",
+                       formatar_contagem(esperado, texto_esperado));
+            }
+            free(remocoes);
+            free(insercoes);
+        }
+        free(remocoes);
+        free(insercoes);
+        fclose(f);
+
+        char texto_total[48];
+        printf("Tempo de atualizações: %.6f segundos (%d lotes)\n", tempo_total, num_lotes);
+        printf("Contagem após as atualizações: %s\n", formatar_contagem(total, texto_total));
+        return total;
+    }
+
+    // Subgrafo k-clique-denso (--densa=arquivo): o S que maximiza cliques(S) /
+    // |S|. Cada vértice começa com o número de k-cliques que o contêm; a cada
+    // rodada saem juntos todos os vivos com contagem <= (1 + ε) k T / |S| (T =
+    // cliques entre os |S| restantes; a média é k T / |S|, então sempre sai
+    // alguém), e só as cliques destruídas por eles são percorridas para
+    // descontar os vizinhos vivos. O melhor S visto está a um fator k (1 + ε)
+    // do ótimo, com O(log |V| / ε) rodadas.
+    #define DENSA_VIVO 0
+    #define DENSA_SAINDO 1
+    #define DENSA_REMOVIDO 2
+
+    // Percorre as cliques formadas por clique[0 .. tamanho) mais "falta"
+    // vértices de candidatos (ordenados, todos adjacentes à clique), somando
+    // "incremento" à contagem de cada membro vivo. Devolve quantas são.
+    contagem_t percorrer_cliques(AdjacenciaDinamica* d, int* clique, int tamanho, const int* candidatos, int n,
+                                 int falta, const uint8_t* estado, contagem_t* por_vertice, contagem_t incremento) {
+        if (falta == 0) {
+            for (int i = 0; i < tamanho; i++) {
+                if (estado[clique[i]] == DENSA_VIVO) {
+                    #pragma omp atomic
+                    por_vertice[clique[i]] += incremento;
+                }
+            }
+            return 1;
+        }
+        contagem_t total = 0;
+        int* proximos = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+        for (int i = 0; i + falta <= n; i++) {
+            int w = candidatos[i];
+            const int* lista = d->vizinhos[w];
+            int m = 0;
+            for (int a = i + 1, b = posicao_vizinho(d, w, w + 1); a < n && b < d->grau[w];) {
+                if (candidatos[a] < lista[b]) {
+                    a++;
+                } else if (candidatos[a] > lista[b]) {
+                    b++;
+                } else {
+                    proximos[m++] = candidatos[a];
+                    a++;
+                    b++;
+                }
+            }
+            if (m >= falta - 1) {
+                clique[tamanho] = w;
+                total += percorrer_cliques(d, clique, tamanho + 1, proximos, m, falta - 1, estado,
+                                           por_vertice, incremento);
+            }
+        }
+        free(proximos);
+        return total;
+    }
+
+    static inline double densidade(contagem_t cliques, int vertices) {
+        return vertices > 0 ? (double)cliques / vertices : 0.0;
+    }
+
+    // Grava em "arquivo" os vértices do subgrafo (IDs do arquivo de entrada, em
+    // ordem crescente) e imprime o resumo.
+    void subgrafo_denso(AdjacenciaDinamica* d, int k, double epsilon, int num_threads, Reordenacao* r,
+                        const char* arquivo) {
+        int V = d->V;
+        uint8_t* estado = (uint8_t*)calloc(V, 1);
+        contagem_t* por_vertice = (contagem_t*)calloc(V, sizeof(contagem_t));
+        int* rodada = (int*)malloc(V * sizeof(int));
+        int* lote = (int*)malloc(V * sizeof(int));
+        double inicio = omp_get_wtime();
+
+        contagem_t total = 0;
+        omp_set_num_threads(num_threads);
+        #pragma omp parallel for schedule(dynamic) reduction(+:total)
+        for (int v = 0; v < V; v++) {
+            int clique[k];
+            clique[0] = v;
+            int p = posicao_vizinho(d, v, v + 1);
+            total += percorrer_cliques(d, clique, 1, d->vizinhos[v] + p, d->grau[v] - p, k - 1, estado,
+                                       por_vertice, 1);
+        }
+        double tempo_contagem = omp_get_wtime() - inicio;
+
+        int restantes = V, rodadas = 0;
+        int melhor_rodada = 0, melhor_vertices = V;
+        contagem_t melhor_cliques = total;
+        while (restantes > 0) {
+            long double limiar = (1.0L + epsilon) * k * (long double)total / restantes;
+            int n = 0;
+            #pragma omp parallel for
+            for (int v = 0; v < V; v++) {
+                if (estado[v] == DENSA_VIVO && (long double)por_vertice[v] <= limiar) {
+                    int posicao;
+                    #pragma omp atomic capture
+                    posicao = n++;
+                    lote[posicao] = v;
+                }
+            }
+            for (int i = 0; i < n; i++) {
+                estado[lote[i]] = DENSA_SAINDO;
+            }
+
+            // Cada clique destruída é descontada pelo menor vértice do lote que
+            // ela contém: os outros do lote só entram como candidatos maiores.
+            contagem_t destruidas = 0;
+            #pragma omp parallel for schedule(dynamic) reduction(+:destruidas)
+            for (int i = 0; i < n; i++) {
+                int v = lote[i];
+                int* candidatos = (int*)malloc((d->grau[v] > 0 ? d->grau[v] : 1) * sizeof(int));
+                int m = 0;
+                for (int j = 0; j < d->grau[v]; j++) {
+                    int u = d->vizinhos[v][j];
+                    if (estado[u] == DENSA_VIVO || (estado[u] == DENSA_SAINDO && u > v)) {
+                        candidatos[m++] = u;
+                    }
+                }
+                int clique[k];
+                clique[0] = v;
+                destruidas += percorrer_cliques(d, clique, 1, candidatos, m, k - 1, estado, por_vertice,
+                                                (contagem_t)-1);
+                free(candidatos);
+            }
+
+            for (int i = 0; i < n; i++) {
+                estado[lote[i]] = DENSA_REMOVIDO;
+                rodada[lote[i]] = rodadas;
+            }
+            total -= destruidas;
+            restantes -= n;
+            rodadas++;
+            if (densidade(total, restantes) > densidade(melhor_cliques, melhor_vertices)) {
+                melhor_rodada = rodadas;
+                melhor_vertices = restantes;
+                melhor_cliques = total;
+            }
+        }
+        double tempo_total = omp_get_wtime() - inicio;
+
+        // O melhor S é o que restava no início da rodada "melhor_rodada".
+        FILE* saida = fopen(arquivo, "w");
+        if (saida == NULL) {
+            fprintf(stderr, "Erro ao criar %s\n", arquivo);
+        } else {
+            int n = 0;
+            for (int v = 0; v < V; v++) {
+                if (rodada[v] >= melhor_rodada) {
+                    lote[n++] = id_original(r, v);
+                }
+            }
+            qsort(lote, n, sizeof(int), comparar_int);
+            for (int i = 0; i < n; i++) {
+                fprintf(saida, "%d\n", lote[i]);
+            }
+            fclose(saida);
+        }
+
+        char texto[48];
+        printf("Subgrafo %d-clique-denso: %d vértices, %s cliques, densidade %.6f (rodada %d de %d, ε = %g)\n",
+               k, melhor_vertices, formatar_contagem(melhor_cliques, texto),
+               densidade(melhor_cliques, melhor_vertices), melhor_rodada, rodadas, epsilon);
+        printf("Tempo do subgrafo denso: %.6f segundos (contagem por vértice %.6f, remoção %.6f)\n",
+               tempo_total, tempo_contagem, tempo_total - tempo_contagem);
+
+        free(estado);
+        free(por_vertice);
+        free(rodada);
+        free(lote);
+    }
+
+    // CPUs permitidas ao processo agrupadas por nó NUMA, lidas de
+    // /sys/devices/system/node. Sem essa informação, tudo fica no nó 0.
+    typedef struct Topologia {
+        int num_nos;
+        int num_cpus;
+        int* cpus;
+        int* no;
+    } Topologia;
+
+    Topologia* detectar_topologia(void) {
+        cpu_set_t permitidas;
+        CPU_ZERO(&permitidas);
+        if (sched_getaffinity(0, sizeof(permitidas), &permitidas) != 0) {
+            for (int c = 0; c < CPU_SETSIZE; c++) {
+                CPU_SET(c, &permitidas);
+            }
+        }
+        Topologia* t = (Topologia*)calloc(1, sizeof(Topologia));
+        t->cpus = (int*)malloc(CPU_SETSIZE * sizeof(int));
+        t->no = (int*)malloc(CPU_SETSIZE * sizeof(int));
+        bool vista[CPU_SETSIZE];
+        memset(vista, 0, sizeof(vista));
+
+        for (int n = 0; n < 1024; n++) {
+            char caminho[96];
+            snprintf(caminho, sizeof(caminho), "/sys/devices/system/node/node%d/cpulist", n);
+            FILE* f = fopen(caminho, "r");
+            if (f == NULL) {
+                if (n > 0 && t->num_nos > 0) {
+                    break;
+                }
+                continue;
+            }
+            int antes = t->num_cpus;
+            int a, b;
+            char sep;
+            while (fscanf(f, "%d", &a) == 1) {
+                b = a;
+                if (fscanf(f, "%c", &sep) == 1 && sep == '-') {
+                    if (fscanf(f, "%d", &b) != 1) {
+                        break;
+                    }
+                    if (fscanf(f, "%c", &sep) != 1) {
+                        sep = '\n';
+                    }
+                }
+                for (int c = a; c <= b && c < CPU_SETSIZE; c++) {
+                    if (CPU_ISSET(c, &permitidas) && !vista[c]) {
+                        vista[c] = true;
+                        t->cpus[t->num_cpus] = c;
+                        t->no[t->num_cpus] = t->num_nos;
+                        t->num_cpus++;
+                    }
+                }
+                if (sep != ',') {
+                    break;
+                }
+            }
+            fclose(f);
+            if (t->num_cpus > antes) {
+                t->num_nos++;
+            }
+        }
+        if (t->num_cpus == 0) {
+            t->num_nos = 1;
+            for (int c = 0; c < CPU_SETSIZE; c++) {
+                if (CPU_ISSET(c, &permitidas)) {
+                    t->cpus[t->num_cpus] = c;
+                    t->no[t->num_cpus] = 0;
+                    t->num_cpus++;
+                }
+            }
+        }
+        return t;
+    }
+
+    void liberar_topologia(Topologia* t) {
+        free(t->cpus);
+        free(t->no);
+        free(t);
+    }
+
+    // Índice em t->cpus para a thread "i". "compacta" preenche um nó antes de
+    // passar ao próximo; "espalhada" alterna entre os nós.
+    int posicao_cpu(Topologia* t, const char* politica, int i) {
+        if (strcmp(politica, "espalhada") != 0 || t->num_nos == 1) {
+            return i % t->num_cpus;
+        }
+        int no = i % t->num_nos;
+        int ordem = i / t->num_nos;
+        int cpus_no = 0;
+        for (int c = 0; c < t->num_cpus; c++) {
+            if (t->no[c] == no) {
+                cpus_no++;
+            }
+        }
+        ordem %= cpus_no;
+        for (int c = 0; c < t->num_cpus; c++) {
+            if (t->no[c] == no && ordem-- == 0) {
+                return c;
+            }
+        }
+        return i % t->num_cpus;
+    }
+
+    // Fixa cada thread do time OpenMP numa CPU. O libgomp reaproveita as mesmas
+    // threads nas regiões paralelas seguintes, então a fixação persiste.
+    void fixar_threads_omp(Topologia* t, const char* politica, int num_threads) {
+        omp_set_num_threads(num_threads);
+        #pragma omp parallel
+        {
+            int c = posicao_cpu(t, politica, omp_get_thread_num());
+            cpu_set_t conjunto;
+            CPU_ZERO(&conjunto);
+            CPU_SET(t->cpus[c], &conjunto);
+            sched_setaffinity(0, sizeof(conjunto), &conjunto);
+        }
+    }
+
+    // Perfil com contadores de hardware (--perf). Cada thread do OpenMP abre
+    // os próprios contadores uma vez; como o libgomp reaproveita as threads
+    // entre regiões paralelas, o mesmo conjunto serve para todas as fases,
+    // que só zeram, habilitam e leem. Sem suporte (contêiner sem PMU,
+    // perf_event_paranoid), o perfil é desligado com um aviso.
+    #define NUM_EVENTOS_HW 5
+
+    typedef struct ContadoresHW {
+        int fd[NUM_EVENTOS_HW];
+        uint64_t valor[NUM_EVENTOS_HW];
+        int erro;
+    } ContadoresHW;
+
+    typedef struct PerfilHW {
+        int num_threads;
+        ContadoresHW* threads;
+    } PerfilHW;
+
+    enum { HW_CICLOS, HW_INSTRUCOES, HW_FALHAS_LLC, HW_FALHAS_DESVIO, HW_FALHAS_DTLB };
+
+    static int abrir_evento_hw(uint32_t tipo, uint64_t config) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = tipo;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    // Abre os contadores da thread chamadora; os que falharem ficam em -1.
+    void abrir_contadores_hw(ContadoresHW* c) {
+        const uint64_t leitura_falha = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const uint32_t tipos[NUM_EVENTOS_HW] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                                PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+        const uint64_t configs[NUM_EVENTOS_HW] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                  PERF_COUNT_HW_CACHE_LL | leitura_falha, PERF_COUNT_HW_BRANCH_MISSES,
+                                                  PERF_COUNT_HW_CACHE_DTLB | leitura_falha};
+        c->erro = 0;
+        for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+            c->fd[e] = abrir_evento_hw(tipos[e], configs[e]);
+            if (c->fd[e] < 0 && c->erro == 0) {
+                c->erro = errno;
+            }
+        }
+    }
+
+    // Devolve NULL (com aviso) se nenhum contador pôde ser aberto.
+    PerfilHW* iniciar_perfil_hw(int num_threads) {
+        PerfilHW* p = (PerfilHW*)malloc(sizeof(PerfilHW));
+        p->num_threads = num_threads;
+        p->threads = (ContadoresHW*)calloc(num_threads, sizeof(ContadoresHW));
+        omp_set_num_threads(num_threads);
+        #pragma omp parallel
+        abrir_contadores_hw(&p->threads[omp_get_thread_num()]);
+
+        int abertos = 0;
+        for (int t = 0; t < num_threads; t++) {
+            for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+                abertos += p->threads[t].fd[e] >= 0;
+            }
+        }
+        if (abertos == 0) {
+            fprintf(stderr, "Contadores de hardware indisponíveis (%s); --perf ignorado\n",
+                    strerror(p->threads[0].erro));
+            free(p->threads);
+            free(p);
+            return NULL;
+        }
+        if (abertos < num_threads * NUM_EVENTOS_HW) {
+            fprintf(stderr, "Alguns contadores de hardware não estão disponíveis (%s)\n",
+                    strerror(p->threads[0].erro));
+        }
+        return p;
+    }
+
+    void perfil_iniciar_fase(PerfilHW* p) {
+        if (p == NULL) {
+            return;
+        }
+        for (int t = 0; t < p->num_threads; t++) {
+            for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+                if (p->threads[t].fd[e] >= 0) {
+                    ioctl(p->threads[t].fd[e], PERF_EVENT_IOC_RESET, 0);
+                    ioctl(p->threads[t].fd[e], PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+        }
+    }
+
+    static void imprimir_eventos_hw(const char* rotulo, const uint64_t* v, const bool* ok, long long quadros) {
+        const char* nomes[NUM_EVENTOS_HW] = {"ciclos", "instruções", "falhas LLC", "falhas de desvio", "falhas dTLB"};
+        printf("%s:", rotulo);
+        for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+            if (ok[e]) {
+                printf(" %s %llu,", nomes[e], (unsigned long long)v[e]);
+            } else {
+                printf(" %s n/d,", nomes[e]);
+            }
+        }
+        if (ok[HW_CICLOS] && ok[HW_INSTRUCOES] && v[HW_CICLOS] > 0) {
+            printf(" IPC %.3f\n", (double)v[HW_INSTRUCOES] / v[HW_CICLOS]);
+        } else {
+            printf(" IPC n/d\n");
+        }
+        if (quadros > 0) {
+            printf("    por quadro expandido:");
+            const char* separador = "";
+            for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+                if (ok[e]) {
+                    printf("%s %s %.3f", separador, nomes[e], (double)v[e] / quadros);
+                    separador = ",";
+                }
+            }
+            printf("\n");
+        }
+    }
+
+    // Lê e desabilita os contadores (valores escalados se houve multiplexação)
+    // e imprime o total da fase e, com mais de uma thread, cada thread.
+    void perfil_encerrar_fase(PerfilHW* p, const char* fase, long long quadros) {
+        if (p == NULL) {
+            return;
+        }
+        uint64_t total[NUM_EVENTOS_HW] = {0};
+        bool ok[NUM_EVENTOS_HW] = {false};
+        for (int t = 0; t < p->num_threads; t++) {
+            ContadoresHW* c = &p->threads[t];
+            for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+                c->valor[e] = 0;
+                if (c->fd[e] < 0) {
+                    continue;
+                }
+                ioctl(c->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+                uint64_t leitura[3];
+                if (read(c->fd[e], leitura, sizeof(leitura)) == sizeof(leitura) && leitura[2] > 0) {
+                    c->valor[e] = (uint64_t)((double)leitura[0] * leitura[1] / leitura[2]);
+                }
+                total[e] += c->valor[e];
+                ok[e] = true;
+            }
+        }
+        char rotulo[96];
+        snprintf(rotulo, sizeof(rotulo), "Perfil HW (%s)", fase);
+        imprimir_eventos_hw(rotulo, total, ok, quadros);
+        for (int t = 0; t < p->num_threads && p->num_threads > 1; t++) {
+            bool ok_thread[NUM_EVENTOS_HW];
+            for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+                ok_thread[e] = p->threads[t].fd[e] >= 0;
+            }
+            snprintf(rotulo, sizeof(rotulo), "  Thread %d", t);
+            imprimir_eventos_hw(rotulo, p->threads[t].valor, ok_thread, 0);
+        }
+    }
+
+    void liberar_perfil_hw(PerfilHW* p) {
+        if (p == NULL) {
+            return;
+        }
+        for (int t = 0; t < p->num_threads; t++) {
+            for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+                if (p->threads[t].fd[e] >= 0) {
+                    close(p->threads[t].fd[e]);
+                }
+            }
+        }
+        free(p->threads);
+        free(p);
+    }
+
+    bool tem_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+        for (int i = primeiro; i < argc; i++) {
+            if (strncmp(argv[i], "--", 2) == 0 && strcmp(argv[i] + 2, nome) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Procura "--nome=valor" nos argumentos opcionais.
+    const char* obter_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+        size_t n = strlen(nome);
+        for (int i = primeiro; i < argc; i++) {
+            if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, nome, n) == 0
+                && argv[i][n + 2] == '=') {
+                return argv[i] + n + 3;
+            }
+        }
+        return NULL;
+    }
+
+    // Datasets fora da lista (por exemplo, gerados pelo gerador.c): o número de
+    // vértices é o maior ID em <dataset>.edgelist mais um.
+    int vertices_do_arquivo(const char* dataset) {
+        char arquivo[110];
+        snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+        FILE* f = fopen(arquivo, "r");
+        if (f == NULL) {
+            return -1;
+        }
+        int u, v, maior = -1;
+        while (fscanf(f, "%d %d", &u, &v) == 2) {
+            maior = u > maior ? u : maior;
+            maior = v > maior ? v : maior;
+        }
+        fclose(f);
+        return maior + 1;
+    }
+
+    int main(int argc, char *argv[]) {
+        if (argc < 4) {
+            fprintf(stderr, "Uso: <schedule> <dataset> <k> [--ordem=grau|degeneracia|rcm|bfs] [--listar=arquivo] [--limiar-hub=N] [--formato=hibrido|comprimido] [--threads=N] [--afinidade=compacta|espalhada] [--paginas-grandes] [--trace=arquivo.json] [--perf] [--atualizacoes=arquivo] [--verificar] [--checkpoint=arquivo] [--intervalo-checkpoint=segundos] [--densa=arquivo] [--epsilon-densa=valor]\n");
+            return 1;
+        }
+
+        char* schedule = argv[1];
+        char* dataset = argv[2];
+        int k = atoi(argv[3]);
+        
+        struct timespec start_time, end_time;
+        
+        int num_vertices;
+        if (strcmp(dataset, "citeseer") == 0) {
+            num_vertices = 3312;
+        } else if (strcmp(dataset, "ca_astroph") == 0) {
+            num_vertices = 18772;
+        } else if (strcmp(dataset, "dblp") == 0) {
+            num_vertices = 317080;
+        } else {
+            num_vertices = vertices_do_arquivo(dataset);
+            if (num_vertices <= 0) {
+                fprintf(stderr, "Dataset desconhecido: %s\n", dataset);
+                return 1;
+            }
+        }
+
+        Grafo* g = criar_grafo(num_vertices);
+
+        char arquivo[110];
+        snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+
+        const char* opcao_threads = obter_opcao(argc, argv, 4, "threads");
+        int num_threads = opcao_threads != NULL ? atoi(opcao_threads) : omp_get_max_threads();
+        if (num_threads < 1) {
+            num_threads = 1;
+        }
+
+        // --perf: contadores de hardware por thread em cada fase.
+        PerfilHW* perfil = tem_opcao(argc, argv, 4, "perf") ? iniciar_perfil_hw(num_threads) : NULL;
+
+        struct timespec inicio_fase;
+        clock_gettime(CLOCK_MONOTONIC, &inicio_fase);
+        perfil_iniciar_fase(perfil);
+        carregar_grafo_de_arquivo(g, arquivo);
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        printf("Tempo de carga: %.6f segundos\n",
+               (end_time.tv_sec - inicio_fase.tv_sec) + (end_time.tv_nsec - inicio_fase.tv_nsec) / 1e9);
+        perfil_encerrar_fase(perfil, "carga", 0);
+        perfil_iniciar_fase(perfil);
+        clock_gettime(CLOCK_MONOTONIC, &inicio_fase);
+
+        Reordenacao* reordenacao = NULL;
+        const char* ordem = obter_opcao(argc, argv, 4, "ordem");
+        if (ordem != NULL && strcmp(ordem, "nenhuma") != 0) {
+            clock_gettime(CLOCK_MONOTONIC, &start_time);
+            reordenacao = calcular_reordenacao(g, ordem);
+            if (reordenacao == NULL) {
+                fprintf(stderr, "Ordem desconhecida: %s\n", ordem);
+                liberar_grafo(g);
+                return 1;
+            }
+            Grafo* permutado = aplicar_reordenacao(g, reordenacao);
+            liberar_grafo(g);
+            g = permutado;
+            clock_gettime(CLOCK_MONOTONIC, &end_time);
+            printf("Tempo de reordenação (%s): %.6f segundos\n", ordem,
+                   (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+        }
+
+        const char* afinidade = obter_opcao(argc, argv, 4, "afinidade");
+        if (afinidade != NULL && strcmp(afinidade, "nenhuma") != 0) {
+            Topologia* topologia = detectar_topologia();
+            fixar_threads_omp(topologia, afinidade, num_threads);
+            printf("Afinidade %s: %d threads em %d CPUs, %d nós NUMA\n",
+                   afinidade, num_threads, topologia->num_cpus, topologia->num_nos);
+            liberar_topologia(topologia);
+        }
+
+        const char* limiar = obter_opcao(argc, argv, 4, "limiar-hub");
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        g->indice = construir_indice(g, limiar != NULL ? atoi(limiar) : 128, num_threads,
+                                     tem_opcao(argc, argv, 4, "paginas-grandes"));
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        printf("Tempo de construção do índice: %.6f segundos\n",
+               (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+        printf("Índice de adjacência: %d hubs (limiar %d, %d em bitmap), listas %.2f MB, hubs %.2f MB\n",
+               g->indice->num_hubs, g->indice->limiar, g->indice->num_bitmaps,
+               g->indice->bytes_listas / 1048576.0, g->indice->bytes_hubs / 1048576.0);
+
+        // --atualizacoes e --densa: cópias das listas completas, feitas antes
+        // de uma eventual compressão liberar o índice.
+        const char* atualizacoes = obter_opcao(argc, argv, 4, "atualizacoes");
+        AdjacenciaDinamica* dinamica = NULL;
+        if (atualizacoes != NULL) {
+            dinamica = criar_adjacencia_dinamica(g->indice, g->V);
+        }
+        const char* densa = obter_opcao(argc, argv, 4, "densa");
+        AdjacenciaDinamica* adjacencia_densa = NULL;
+        if (densa != NULL) {
+            adjacencia_densa = criar_adjacencia_dinamica(g->indice, g->V);
+        }
+
+        const char* formato = obter_opcao(argc, argv, 4, "formato");
+        if (formato != NULL && strcmp(formato, "comprimido") == 0) {
+            clock_gettime(CLOCK_MONOTONIC, &start_time);
+            g->comprimida = comprimir_adjacencia(g->indice, g->V);
+            clock_gettime(CLOCK_MONOTONIC, &end_time);
+            printf("Tempo de compressão: %.6f segundos\n",
+                   (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+            comparar_formatos(g->indice, g->comprimida, g->V);
+
+            // Na contagem só a forma comprimida fica residente.
+            liberar_indice(g->indice, g->V);
+            g->indice = NULL;
+            for (int v = 0; v < g->V; v++) {
+                Nodo* nodo_atual = g->adj[v];
+                while (nodo_atual != NULL) {
+                    Nodo* prox = nodo_atual->prox;
+                    free(nodo_atual);
+                    nodo_atual = prox;
+                }
+                g->adj[v] = NULL;
+            }
+        } else if (formato != NULL && strcmp(formato, "hibrido") != 0) {
+            fprintf(stderr, "Formato desconhecido: %s\n", formato);
+            liberar_grafo(g);
+            return 1;
+        }
+
+        FILE* saida = NULL;
+        const char* listar = obter_opcao(argc, argv, 4, "listar");
+        if (listar != NULL) {
+            saida = fopen(listar, "w");
+            if (saida == NULL) {
+                fprintf(stderr, "Erro ao criar %s\n", listar);
+                return 1;
+            }
+        }
+
+        const char* trilha = obter_opcao(argc, argv, 4, "trace");
+    #ifdef INSTRUMENTAR
+        int threads_instrumentadas = strcmp(schedule, "serial") == 0 ? 1 : num_threads;
+        iniciar_instrumentacao(threads_instrumentadas, trilha != NULL);
+    #else
+        if (trilha != NULL) {
+            fprintf(stderr, "--trace requer compilação com -DINSTRUMENTAR; ignorado\n");
+        }
+    #endif
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        printf("Tempo de pré-processamento: %.6f segundos\n",
+               (start_time.tv_sec - inicio_fase.tv_sec) + (start_time.tv_nsec - inicio_fase.tv_nsec) / 1e9);
+        perfil_encerrar_fase(perfil, "pré-processamento", 0);
+        perfil_iniciar_fase(perfil);
+        // --checkpoint: grava as raízes concluídas a cada --intervalo-checkpoint
+        // segundos (padrão 60) e, se o arquivo já existe, retoma dele.
+        const char* arquivo_checkpoint = obter_opcao(argc, argv, 4, "checkpoint");
+        Checkpoint* checkpoint = NULL;
+        if (arquivo_checkpoint != NULL) {
+            const char* intervalo = obter_opcao(argc, argv, 4, "intervalo-checkpoint");
+            checkpoint = abrir_checkpoint(arquivo_checkpoint, dataset, reordenacao != NULL ? ordem : "nenhuma",
+                                          k, g->V, intervalo != NULL ? atof(intervalo) : 60.0);
+            if (saida != NULL && checkpoint->num_concluidas > 0) {
+                fprintf(stderr, "--listar: as cliques das raízes já concluídas não são listadas de novo\n");
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        contagem_t resultado = checkpoint != NULL
+            ? contagem_com_checkpoint(g, k, schedule, num_threads, saida, reordenacao, checkpoint)
+            : contagem_de_cliques_serial(g, k, schedule, num_threads, saida, reordenacao);
+
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        perfil_encerrar_fase(perfil, "contagem", quadros_expandidos);
+        
+        double time_spent = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+        printf("Tempo de execução: %.6f segundos\n", time_spent);
+
+        char texto_contagem[48];
+        printf("Número de cliques de tamanho %d: %s\n", k, formatar_contagem(resultado, texto_contagem));
+        INSTR(relatar_instrumentacao(threads_instrumentadas, time_spent, trilha));
+
+        if (checkpoint != NULL) {
+            printf("Checkpoints: %d gravações, %.2f KB, %.6f segundos (%.2f%% da contagem)\n",
+                   checkpoint->gravacoes, checkpoint->bytes / 1024.0, checkpoint->tempo_gravacao,
+                   time_spent > 0 ? 100.0 * checkpoint->tempo_gravacao / time_spent : 0.0);
+            // Contagem completa: o checkpoint não serve mais.
+            unlink(arquivo_checkpoint);
+            liberar_checkpoint(checkpoint);
+        }
+
+        if (adjacencia_densa != NULL) {
+            const char* epsilon = obter_opcao(argc, argv, 4, "epsilon-densa");
+            subgrafo_denso(adjacencia_densa, k, epsilon != NULL ? atof(epsilon) : 0.1, num_threads,
+                           reordenacao, densa);
+            liberar_adjacencia_dinamica(adjacencia_densa);
+        }
+
+        if (dinamica != NULL) {
+            processar_atualizacoes(dinamica, atualizacoes, k, num_threads, reordenacao, resultado,
+                                   tem_opcao(argc, argv, 4, "verificar"));
+            liberar_adjacencia_dinamica(dinamica);
+        }
+
+        if (saida != NULL) {
+            fclose(saida);
+        }
+        liberar_perfil_hw(perfil);
+        liberar_reordenacao(reordenacao);
         liberar_grafo(g);
 
 
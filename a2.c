@@ -4,6 +4,7 @@
 #include <string.h>
 #include <pthread.h>
 #include <time.h>
+#include <stdint.h>
 
 #define MAX_TAREFAS_ROUBADAS 150 
 
@@ -17,6 +18,33 @@ typedef struct Grafo {
     Nodo** adj;
 } Grafo;
 
+// Tipo das contagens de cliques: 64 bits sem sinal; com -DCONTAGEM_128,
+// 128 bits (o printf não formata esse tipo, daí formatar_contagem).
+#ifdef CONTAGEM_128
+typedef unsigned __int128 contagem_t;
+#else
+typedef uint64_t contagem_t;
+#endif
+
+const char* formatar_contagem(contagem_t c, char* texto) {
+    char invertido[48];
+    int n = 0;
+    do {
+        invertido[n++] = (char)('0' + (int)(c % 10));
+        c /= 10;
+    } while (c > 0);
+    for (int i = 0; i < n; i++) {
+        texto[i] = invertido[n - 1 - i];
+    }
+    texto[n] = '\0';
+    return texto;
+}
+
+// Acumulador por thread em linha de cache própria, escrito uma vez no fim.
+typedef struct ContadorThread {
+    contagem_t valor;
+} __attribute__((aligned(64))) ContadorThread;
+
 typedef struct Lista {
     int* vertices;
     int tamanho;
@@ -26,9 +54,11 @@ typedef struct Lista {
 typedef struct ThreadData {
     Grafo* g;
     int k;
-    int* contador;
+    ContadorThread* contador;
     Lista** trabalhos;
     Lista** todas_pilhas; // Para acesso às pilhas de outras threads
+    pthread_mutex_t* mutexes; // Um por pilha: dona e ladrões disputam o topo
+    int thread_id;
     int num_threads;
 } ThreadData;
 
@@ -125,30 +155,34 @@ void* contagem_de_cliques_thread(void* args) {
     ThreadData* dados = (ThreadData*)args;
     Grafo* g = dados->g;
     int k = dados->k;
-    int* contador = dados->contador;
+    contagem_t contador = 0;
     Lista** pilha_trabalho = dados->trabalhos;
+    pthread_mutex_t* mutex = &dados->mutexes[dados->thread_id];
 
     int tarefas_roubadas = 0; // Contador de tarefas roubadas
 
     while (true) {
+        pthread_mutex_lock(mutex);
         Lista* clique_atual = desempilhar(pilha_trabalho);
+        pthread_mutex_unlock(mutex);
 
         if (clique_atual == NULL) {
-            // Roubo de carga: tentar roubar trabalho de outra pilha, respeitando o limite
+            // Roubo de carga: tentar roubar trabalho de outra pilha, respeitando o limite.
+            // Quem não rouba mais só sai com a própria pilha vazia; o que
+            // restou nas outras é terminado pelas donas.
             bool roubou_trabalho = false;
-            for (int i = 0; i < dados->num_threads && !roubou_trabalho; i++) {
-                if (dados->todas_pilhas[i] != *pilha_trabalho) {
+            for (int i = 0; i < dados->num_threads && !roubou_trabalho
+                            && tarefas_roubadas < MAX_TAREFAS_ROUBADAS; i++) {
+                if (i != dados->thread_id) {
+                    pthread_mutex_lock(&dados->mutexes[i]);
                     Lista* clique_roubado = desempilhar(&dados->todas_pilhas[i]);
+                    pthread_mutex_unlock(&dados->mutexes[i]);
                     if (clique_roubado != NULL) {
                         clique_atual = clique_roubado;
                         tarefas_roubadas++; // Incrementar o contador de tarefas roubadas
                         roubou_trabalho = true;
                     }
                 }
-                // Verificar se atingiu o limite de tarefas roubadas
-                if (tarefas_roubadas >= MAX_TAREFAS_ROUBADAS) {
-                    break; // Parar se o limite for atingido
-                }
             }
 
             if (!roubou_trabalho) {
@@ -158,7 +192,7 @@ void* contagem_de_cliques_thread(void* args) {
 
         // Processo de contagem de cliques
         if (clique_atual->tamanho == k) {
-            (*contador)++;
+            contador++;
             free(clique_atual->vertices);
             free(clique_atual);
             continue;
@@ -170,7 +204,10 @@ void* contagem_de_cliques_thread(void* args) {
                 int* novo_clique = (int*)malloc(novo_tamanho * sizeof(int));
                 memcpy(novo_clique, clique_atual->vertices, clique_atual->tamanho * sizeof(int));
                 novo_clique[novo_tamanho - 1] = v;
+                pthread_mutex_lock(mutex);
                 empilhar(pilha_trabalho, novo_clique, novo_tamanho);
+                pthread_mutex_unlock(mutex);
+                free(novo_clique);
             }
         }
 
@@ -178,17 +215,20 @@ void* contagem_de_cliques_thread(void* args) {
         free(clique_atual);
     }
 
+    dados->contador->valor = contador;
     return NULL;
 }
 
-int contagem_de_cliques_paralela(Grafo* g, int k, int num_threads) {
+contagem_t contagem_de_cliques_paralela(Grafo* g, int k, int num_threads) {
     Lista* cliques = NULL;
     pthread_t threads[num_threads];
     ThreadData dados[num_threads];
-    int contadores[num_threads];
+    ContadorThread contadores[num_threads];
+    pthread_mutex_t mutexes[num_threads];
 
     for (int i = 0; i < num_threads; i++) {
-        contadores[i] = 0;
+        contadores[i].valor = 0;
+        pthread_mutex_init(&mutexes[i], NULL);
     }
 
     for (int v = 0; v < g->V; v++) {
@@ -217,6 +257,8 @@ int contagem_de_cliques_paralela(Grafo* g, int k, int num_threads) {
         dados[i].contador = &contadores[i];
         dados[i].trabalhos = &trabalho_por_thread[i];
         dados[i].todas_pilhas = trabalho_por_thread;
+        dados[i].mutexes = mutexes;
+        dados[i].thread_id = i;
         dados[i].num_threads = num_threads;
         pthread_create(&threads[i], NULL, contagem_de_cliques_thread, &dados[i]);
     }
@@ -225,9 +267,10 @@ int contagem_de_cliques_paralela(Grafo* g, int k, int num_threads) {
         pthread_join(threads[i], NULL);
     }
 
-    int total_contador = 0;
+    contagem_t total_contador = 0;
     for (int i = 0; i < num_threads; i++) {
-        total_contador += contadores[i];
+        total_contador += contadores[i].valor;
+        pthread_mutex_destroy(&mutexes[i]);
     }
 
     return total_contador;
@@ -246,17 +289,35 @@ void liberar_grafo(Grafo* g) {
     free(g);
 }
 
+// Datasets fora da lista (por exemplo, gerados pelo gerador.c): o número de
+// vértices é o maior ID em <dataset>.edgelist mais um.
+int vertices_do_arquivo(const char* dataset) {
+    char arquivo[110];
+    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+    FILE* f = fopen(arquivo, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    int u, v, maior = -1;
+    while (fscanf(f, "%d %d", &u, &v) == 2) {
+        maior = u > maior ? u : maior;
+        maior = v > maior ? v : maior;
+    }
+    fclose(f);
+    return maior + 1;
+}
+
 int main(int argc, char *argv[]) {
     if (argc != 4) {
         fprintf(stderr, "Usage: %s <dataset> <k> <num_threads>\n", argv[0]);
         return 1;
     }
 
-    char dataset[30];
+    char dataset[100];
     int k, num_threads;
-    strcpy(dataset, argv[1]);
+    snprintf(dataset, sizeof(dataset), "%s", argv[1]);
     k = atoi(argv[2]);
-    num_threads = atoi(argv[2]);
+    num_threads = atoi(argv[3]);
     struct timespec start_time, end_time;
 
     int num_vertices;
@@ -267,7 +328,11 @@ int main(int argc, char *argv[]) {
     } else if (strcmp(dataset, "dblp") == 0) {
         num_vertices = 317080;
     } else {
-        return 1;
+        num_vertices = vertices_do_arquivo(dataset);
+        if (num_vertices <= 0) {
+            fprintf(stderr, "Dataset desconhecido: %s\n", dataset);
+            return 1;
+        }
     }
 
     Grafo* g = criar_grafo(num_vertices);
@@ -275,11 +340,15 @@ int main(int argc, char *argv[]) {
     char arquivo[110];
     snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
 
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
     carregar_grafo_de_arquivo(g, arquivo);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    printf("Tempo de carga: %.6f segundos\n",
+           (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
 
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-    int resultado = contagem_de_cliques_paralela(g, k, num_threads);
+    contagem_t resultado = contagem_de_cliques_paralela(g, k, num_threads);
 
     clock_gettime(CLOCK_MONOTONIC, &end_time);
     
@@ -288,7 +357,8 @@ int main(int argc, char *argv[]) {
 
     printf("Tempo de execução: %.6f segundos\n", time_spent);
 
-    printf("Número de cliques de tamanho %d: %d\n", k, resultado);
+    char texto_contagem[48];
+    printf("Número de cliques de tamanho %d: %s\n", k, formatar_contagem(resultado, texto_contagem));
 
     liberar_grafo(g);
 
@@ -0,0 +1,40 @@
+#!/bin/sh
+# Compara o tempo da fase de contagem e as falhas de LLC para cada ordem de
+# vértices do a1.c.
+# Uso: ./bench_ordenacao.sh <dataset> <k> [schedule] [repeticoes]
+# As falhas de LLC vêm do "perf stat" (processo inteiro, inclui a carga);
+# sem perf disponível, apenas os tempos são mostrados.
+
+DATASET=${1:-citeseer}
+K=${2:-4}
+SCHEDULE=${3:-dynamic}
+REPETICOES=${4:-3}
+BIN=./a1
+
+if [ ! -x "$BIN" ]; then
+    gcc -O2 -fopenmp a1.c -o "$BIN" || exit 1
+fi
+
+USAR_PERF=0
+if command -v perf >/dev/null 2>&1 && perf stat -e LLC-load-misses true >/dev/null 2>&1; then
+    USAR_PERF=1
+fi
+
+printf "%-12s %-12s %-16s %-10s\n" "ordem" "contagem(s)" "LLC-load-misses" "cliques"
+for ORDEM in nenhuma grau degeneracia rcm bfs; do
+    i=0
+    while [ $i -lt "$REPETICOES" ]; do
+        if [ $USAR_PERF -eq 1 ]; then
+            SAIDA=$(perf stat -x, -e LLC-load-misses "$BIN" "$SCHEDULE" "$DATASET" "$K" --ordem=$ORDEM 2>/tmp/perf_ordem.$$)
+            FALHAS=$(grep LLC-load-misses /tmp/perf_ordem.$$ | cut -d, -f1)
+        else
+            SAIDA=$("$BIN" "$SCHEDULE" "$DATASET" "$K" --ordem=$ORDEM)
+            FALHAS="-"
+        fi
+        TEMPO=$(echo "$SAIDA" | grep "Tempo de execução" | awk '{print $4}')
+        CLIQUES=$(echo "$SAIDA" | grep "Número de cliques" | awk '{print $NF}')
+        printf "%-12s %-12s %-16s %-10s\n" "$ORDEM" "$TEMPO" "$FALHAS" "$CLIQUES"
+        i=$((i + 1))
+    done
+done
+rm -f /tmp/perf_ordem.$$
@@ -0,0 +1,552 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+// Driver único de benchmark: varre motores, datasets, k e número de threads
+// (ou ranks), repete cada configuração e grava mediana e percentis de cada
+// fase (carga, pré-processamento, contagem), do tempo até a resposta e do
+// tempo total do processo em CSV e/ou JSON.
+//
+// Também serve de verificação entre motores: toda contagem é comparada com a
+// referência (--referencias e <dataset>.cliques do gerador.c) e com a dos
+// outros motores para o mesmo dataset e k; com --linha-base=<csv anterior>,
+// medianas de contagem acima de --limite vezes a da linha de base são
+// marcadas como lentidão. Saída 1 para contagens erradas ou falhas, 2 só
+// para lentidão.
+//
+// Os executáveis são chamados como processos e a saída deles é lida:
+//   serial/static/dynamic/guided -> a1 <schedule> <dataset> <k> --threads=T
+//   pthread                      -> count_pthread <dataset> <k> <T> <maxv>
+//   a2                           -> a2 <dataset> <k> <T>
+//   mpi                          -> echo "<dataset> <k>" | mpirun -np R t3-mpi
+//
+// Compilação:
+//   gcc -O2 -fopenmp a1.c -o a1
+//   gcc -O2 -pthread count_pthread.c -o count_pthread
+//   gcc -O2 -pthread a2.c -o a2
+//   mpicc -O2 t3-mpi.c -o t3-mpi
+//   gcc -O2 benchmark.c -o benchmark -lm
+
+#define MAX_ITENS 32
+#define MAX_COMANDO 1024
+
+typedef struct ListaTexto {
+    char* itens[MAX_ITENS];
+    int n;
+} ListaTexto;
+
+typedef struct Amostra {
+    double carga;
+    double preproc;
+    double contagem;
+    double resposta;
+    double total;
+    long long cliques;
+    bool ok;
+} Amostra;
+
+typedef struct Resultado {
+    char motor[32];
+    char dataset[64];
+    int k;
+    int paralelismo;
+    int repeticoes;
+    int falhas;
+    long long cliques;
+    bool consistente;
+    long long esperado;
+    Amostra* amostras;
+    double base_contagem;
+    double linha_base;
+} Resultado;
+
+typedef struct Config {
+    ListaTexto motores;
+    ListaTexto datasets;
+    ListaTexto ks;
+    ListaTexto threads;
+    ListaTexto ranks;
+    int aquecimento;
+    int repeticoes;
+    int maxv;
+    const char* bin;
+    const char* mpirun;
+    const char* args_a1;
+    const char* args_pthread;
+    const char* args_mpi;
+    const char* csv;
+    const char* json;
+    const char* referencias;
+    const char* linha_base;
+    double limite;
+} Config;
+
+// Divide "a,b,c" em itens (a string é copiada).
+void separar(const char* texto, ListaTexto* lista) {
+    lista->n = 0;
+    char* copia = strdup(texto);
+    for (char* item = strtok(copia, ","); item != NULL && lista->n < MAX_ITENS; item = strtok(NULL, ",")) {
+        lista->itens[lista->n++] = strdup(item);
+    }
+    free(copia);
+}
+
+// Procura "--nome=valor" nos argumentos opcionais.
+const char* obter_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+    size_t n = strlen(nome);
+    for (int i = primeiro; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, nome, n) == 0
+            && argv[i][n + 2] == '=') {
+            return argv[i] + n + 3;
+        }
+    }
+    return NULL;
+}
+
+const char* opcao_ou(int argc, char* argv[], const char* nome, const char* padrao) {
+    const char* valor = obter_opcao(argc, argv, 1, nome);
+    return valor != NULL ? valor : padrao;
+}
+
+bool eh_openmp(const char* motor) {
+    return strcmp(motor, "serial") == 0 || strcmp(motor, "static") == 0
+        || strcmp(motor, "dynamic") == 0 || strcmp(motor, "guided") == 0;
+}
+
+bool montar_comando(Config* c, const char* motor, const char* dataset, int k, int p, char* comando) {
+    if (eh_openmp(motor)) {
+        snprintf(comando, MAX_COMANDO, "%s/a1 %s %s %d --threads=%d %s",
+                 c->bin, motor, dataset, k, p, c->args_a1);
+    } else if (strcmp(motor, "pthread") == 0) {
+        snprintf(comando, MAX_COMANDO, "%s/count_pthread %s %d %d %d %s",
+                 c->bin, dataset, k, p, c->maxv, c->args_pthread);
+    } else if (strcmp(motor, "a2") == 0) {
+        snprintf(comando, MAX_COMANDO, "%s/a2 %s %d %d", c->bin, dataset, k, p);
+    } else if (strcmp(motor, "mpi") == 0) {
+        snprintf(comando, MAX_COMANDO, "echo \"%s %d\" | %s %d %s/t3-mpi %s",
+                 dataset, k, c->mpirun, p, c->bin, c->args_mpi);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Lê o valor numérico depois de ":" numa linha que começa com "prefixo".
+bool ler_campo(const char* linha, const char* prefixo, double* valor) {
+    if (strncmp(linha, prefixo, strlen(prefixo)) != 0) {
+        return false;
+    }
+    const char* dois_pontos = strrchr(linha, ':');
+    return dois_pontos != NULL && sscanf(dois_pontos + 1, "%lf", valor) == 1;
+}
+
+Amostra executar(const char* comando) {
+    Amostra a = {0, 0, 0, -1, 0, -1, false};
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    FILE* saida = popen(comando, "r");
+    if (saida == NULL) {
+        return a;
+    }
+    char linha[512];
+    bool tem_contagem = false;
+    while (fgets(linha, sizeof(linha), saida) != NULL) {
+        double valor;
+        if (ler_campo(linha, "Tempo de carga:", &valor)) {
+            a.carga = valor;
+        } else if (ler_campo(linha, "Tempo de pré-processamento:", &valor)) {
+            a.preproc = valor;
+        } else if (ler_campo(linha, "Tempo de execução:", &valor)) {
+            a.contagem = valor;
+            tem_contagem = true;
+        } else if (ler_campo(linha, "Tempo até a resposta:", &valor)) {
+            a.resposta = valor;
+        } else if (strncmp(linha, "Número de cliques", strlen("Número de cliques")) == 0) {
+            const char* dois_pontos = strrchr(linha, ':');
+            if (dois_pontos != NULL) {
+                a.cliques = atoll(dois_pontos + 1);
+            }
+        }
+    }
+    int status = pclose(saida);
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    a.total = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    // Motores que não relatam o tempo até a resposta rodam as fases em
+    // sequência: é a soma delas.
+    if (a.resposta < 0) {
+        a.resposta = a.carga + a.preproc + a.contagem;
+    }
+    a.ok = status == 0 && tem_contagem && a.cliques >= 0;
+    return a;
+}
+
+int comparar_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil por interpolação linear entre as amostras ordenadas.
+double percentil(double* ordenado, int n, double p) {
+    if (n == 0) {
+        return NAN;
+    }
+    double posicao = p / 100.0 * (n - 1);
+    int i = (int)posicao;
+    if (i + 1 >= n) {
+        return ordenado[n - 1];
+    }
+    return ordenado[i] + (posicao - i) * (ordenado[i + 1] - ordenado[i]);
+}
+
+typedef struct Estatistica {
+    double minimo;
+    double mediana;
+    double p10;
+    double p90;
+    double maximo;
+} Estatistica;
+
+Estatistica estatistica(Resultado* r, int campo) {
+    double valores[r->repeticoes];
+    int n = 0;
+    for (int i = 0; i < r->repeticoes; i++) {
+        if (!r->amostras[i].ok) {
+            continue;
+        }
+        double v = campo == 0 ? r->amostras[i].carga
+                 : campo == 1 ? r->amostras[i].preproc
+                 : campo == 2 ? r->amostras[i].contagem
+                 : campo == 3 ? r->amostras[i].resposta
+                 : r->amostras[i].total;
+        valores[n++] = v;
+    }
+    qsort(valores, n, sizeof(double), comparar_double);
+    Estatistica e;
+    e.minimo = n > 0 ? valores[0] : NAN;
+    e.maximo = n > 0 ? valores[n - 1] : NAN;
+    e.mediana = percentil(valores, n, 50);
+    e.p10 = percentil(valores, n, 10);
+    e.p90 = percentil(valores, n, 90);
+    return e;
+}
+
+#define NUM_FASES 5
+
+const char* nomes_fases[NUM_FASES] = {"carga", "preproc", "contagem", "resposta", "total"};
+
+void escrever_csv(const char* arquivo, Resultado* resultados, int n) {
+    FILE* f = fopen(arquivo, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Erro ao criar %s\n", arquivo);
+        return;
+    }
+    fprintf(f, "motor,dataset,k,paralelismo,repeticoes,falhas,cliques,consistente");
+    for (int fase = 0; fase < NUM_FASES; fase++) {
+        fprintf(f, ",%s_min,%s_mediana,%s_p10,%s_p90,%s_max",
+                nomes_fases[fase], nomes_fases[fase], nomes_fases[fase], nomes_fases[fase], nomes_fases[fase]);
+    }
+    fprintf(f, ",aceleracao,eficiencia\n");
+    for (int i = 0; i < n; i++) {
+        Resultado* r = &resultados[i];
+        fprintf(f, "%s,%s,%d,%d,%d,%d,%lld,%d", r->motor, r->dataset, r->k, r->paralelismo,
+                r->repeticoes, r->falhas, r->cliques, r->consistente);
+        for (int fase = 0; fase < NUM_FASES; fase++) {
+            Estatistica e = estatistica(r, fase);
+            fprintf(f, ",%.6f,%.6f,%.6f,%.6f,%.6f", e.minimo, e.mediana, e.p10, e.p90, e.maximo);
+        }
+        double mediana = estatistica(r, 2).mediana;
+        double aceleracao = r->base_contagem / mediana;
+        fprintf(f, ",%.4f,%.4f\n", aceleracao, aceleracao / r->paralelismo);
+    }
+    fclose(f);
+}
+
+// JSON não aceita NaN: fases sem amostras válidas viram null.
+void escrever_numero(FILE* f, const char* nome, double valor) {
+    if (isnan(valor) || isinf(valor)) {
+        fprintf(f, "\"%s\": null", nome);
+    } else {
+        fprintf(f, "\"%s\": %.6f", nome, valor);
+    }
+}
+
+void escrever_json(const char* arquivo, Resultado* resultados, int n) {
+    FILE* f = fopen(arquivo, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Erro ao criar %s\n", arquivo);
+        return;
+    }
+    fprintf(f, "[\n");
+    for (int i = 0; i < n; i++) {
+        Resultado* r = &resultados[i];
+        fprintf(f, "  {\"motor\": \"%s\", \"dataset\": \"%s\", \"k\": %d, \"paralelismo\": %d, "
+                   "\"repeticoes\": %d, \"falhas\": %d, \"cliques\": %lld, \"consistente\": %s",
+                r->motor, r->dataset, r->k, r->paralelismo, r->repeticoes, r->falhas,
+                r->cliques, r->consistente ? "true" : "false");
+        for (int fase = 0; fase < NUM_FASES; fase++) {
+            Estatistica e = estatistica(r, fase);
+            fprintf(f, ",\n   \"%s\": {", nomes_fases[fase]);
+            escrever_numero(f, "min", e.minimo);
+            fprintf(f, ", ");
+            escrever_numero(f, "mediana", e.mediana);
+            fprintf(f, ", ");
+            escrever_numero(f, "p10", e.p10);
+            fprintf(f, ", ");
+            escrever_numero(f, "p90", e.p90);
+            fprintf(f, ", ");
+            escrever_numero(f, "max", e.maximo);
+            fprintf(f, ", \"amostras\": [");
+            bool primeiro = true;
+            for (int j = 0; j < r->repeticoes; j++) {
+                if (!r->amostras[j].ok) {
+                    continue;
+                }
+                double v = fase == 0 ? r->amostras[j].carga
+                         : fase == 1 ? r->amostras[j].preproc
+                         : fase == 2 ? r->amostras[j].contagem
+                         : fase == 3 ? r->amostras[j].resposta
+                         : r->amostras[j].total;
+                fprintf(f, "%s%.6f", primeiro ? "" : ", ", v);
+                primeiro = false;
+            }
+            fprintf(f, "]}");
+        }
+        fprintf(f, ",\n   ");
+        escrever_numero(f, "aceleracao", r->base_contagem / estatistica(r, 2).mediana);
+        fprintf(f, "}%s\n", i + 1 < n ? "," : "");
+    }
+    fprintf(f, "]\n");
+    fclose(f);
+}
+
+// Contagem esperada para (dataset, k): primeiro o arquivo de referências
+// ("dataset k contagem" por linha, "#" comenta), depois <dataset>.cliques
+// ("k contagem", escrito pelo gerador.c). -1 se desconhecida.
+long long contagem_esperada(const char* referencias, const char* dataset, int k) {
+    char linha[256], nome[128];
+    int kr;
+    long long contagem;
+    FILE* f = referencias != NULL ? fopen(referencias, "r") : NULL;
+    if (f != NULL) {
+        while (fgets(linha, sizeof(linha), f) != NULL) {
+            if (linha[0] != '#' && sscanf(linha, "%127s %d %lld", nome, &kr, &contagem) == 3
+                && strcmp(nome, dataset) == 0 && kr == k) {
+                fclose(f);
+                return contagem;
+            }
+        }
+        fclose(f);
+    }
+    snprintf(nome, sizeof(nome), "%s.cliques", dataset);
+    f = fopen(nome, "r");
+    if (f != NULL) {
+        while (fgets(linha, sizeof(linha), f) != NULL) {
+            if (sscanf(linha, "%d %lld", &kr, &contagem) == 2 && kr == k) {
+                fclose(f);
+                return contagem;
+            }
+        }
+        fclose(f);
+    }
+    return -1;
+}
+
+// Mediana de contagem da mesma configuração num CSV gravado antes com
+// --csv; NAN se a configuração não está lá.
+double mediana_da_linha_base(const char* arquivo, Resultado* r) {
+    FILE* f = fopen(arquivo, "r");
+    if (f == NULL) {
+        return NAN;
+    }
+    char linha[4096];
+    int coluna_mediana = -1;
+    double valor = NAN;
+    if (fgets(linha, sizeof(linha), f) != NULL) {
+        int coluna = 0;
+        for (char* campo = strtok(linha, ",\n"); campo != NULL; campo = strtok(NULL, ",\n"), coluna++) {
+            if (strcmp(campo, "contagem_mediana") == 0) {
+                coluna_mediana = coluna;
+            }
+        }
+    }
+    while (coluna_mediana >= 0 && fgets(linha, sizeof(linha), f) != NULL) {
+        char* campos[64];
+        int n = 0;
+        for (char* campo = strtok(linha, ",\n"); campo != NULL && n < 64; campo = strtok(NULL, ",\n")) {
+            campos[n++] = campo;
+        }
+        if (n > coluna_mediana && strcmp(campos[0], r->motor) == 0 && strcmp(campos[1], r->dataset) == 0
+            && atoi(campos[2]) == r->k && atoi(campos[3]) == r->paralelismo) {
+            valor = atof(campos[coluna_mediana]);
+            break;
+        }
+    }
+    fclose(f);
+    return valor;
+}
+
+// A aceleração de cada configuração é relativa à de menor paralelismo do
+// mesmo motor, dataset e k (escalabilidade forte).
+void calcular_bases(Resultado* resultados, int n) {
+    for (int i = 0; i < n; i++) {
+        Resultado* base = NULL;
+        for (int j = 0; j < n; j++) {
+            Resultado* r = &resultados[j];
+            if (strcmp(r->motor, resultados[i].motor) == 0 && strcmp(r->dataset, resultados[i].dataset) == 0
+                && r->k == resultados[i].k && (base == NULL || r->paralelismo < base->paralelismo)) {
+                base = r;
+            }
+        }
+        resultados[i].base_contagem = estatistica(base, 2).mediana;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--ajuda") == 0)) {
+        fprintf(stderr, "Uso: %s [--motores=serial,static,dynamic,guided,pthread,a2,mpi] [--datasets=citeseer]\n"
+                        "       [--k=3,4] [--threads=1,2,4] [--ranks=1,2,4] [--aquecimento=1] [--repeticoes=5]\n"
+                        "       [--bin=.] [--maxv=8] [--mpirun=\"mpirun -np\"] [--args-a1=...] [--args-pthread=...]\n"
+                        "       [--args-mpi=...] [--csv=arquivo] [--json=arquivo] [--referencias=referencias.txt]\n"
+                        "       [--linha-base=anterior.csv] [--limite=1.25]\n", argv[0]);
+        return 1;
+    }
+
+    Config c;
+    separar(opcao_ou(argc, argv, "motores", "serial,dynamic,pthread"), &c.motores);
+    separar(opcao_ou(argc, argv, "datasets", "citeseer"), &c.datasets);
+    separar(opcao_ou(argc, argv, "k", "3,4"), &c.ks);
+    separar(opcao_ou(argc, argv, "threads", "1,2,4"), &c.threads);
+    separar(opcao_ou(argc, argv, "ranks", "1,2"), &c.ranks);
+    c.aquecimento = atoi(opcao_ou(argc, argv, "aquecimento", "1"));
+    c.repeticoes = atoi(opcao_ou(argc, argv, "repeticoes", "5"));
+    c.maxv = atoi(opcao_ou(argc, argv, "maxv", "8"));
+    c.bin = opcao_ou(argc, argv, "bin", ".");
+    c.mpirun = opcao_ou(argc, argv, "mpirun", "mpirun --oversubscribe -np");
+    c.args_a1 = opcao_ou(argc, argv, "args-a1", "");
+    c.args_pthread = opcao_ou(argc, argv, "args-pthread", "");
+    c.args_mpi = opcao_ou(argc, argv, "args-mpi", "");
+    c.csv = obter_opcao(argc, argv, 1, "csv");
+    c.json = obter_opcao(argc, argv, 1, "json");
+    c.referencias = opcao_ou(argc, argv, "referencias", "referencias.txt");
+    c.linha_base = obter_opcao(argc, argv, 1, "linha-base");
+    c.limite = atof(opcao_ou(argc, argv, "limite", "1.25"));
+    if (c.repeticoes < 1) {
+        c.repeticoes = 1;
+    }
+
+    int capacidade = c.motores.n * c.datasets.n * c.ks.n * (c.threads.n > c.ranks.n ? c.threads.n : c.ranks.n);
+    Resultado* resultados = (Resultado*)calloc(capacidade > 0 ? capacidade : 1, sizeof(Resultado));
+    int n = 0;
+
+    printf("%-8s %-12s %3s %4s %12s %12s %12s %12s %12s %12s\n",
+           "motor", "dataset", "k", "par", "cliques", "carga", "preproc", "contagem", "p90", "resposta");
+    for (int m = 0; m < c.motores.n; m++) {
+        const char* motor = c.motores.itens[m];
+        ListaTexto* niveis = strcmp(motor, "mpi") == 0 ? &c.ranks : &c.threads;
+        for (int d = 0; d < c.datasets.n; d++) {
+            for (int ki = 0; ki < c.ks.n; ki++) {
+                for (int p = 0; p < niveis->n; p++) {
+                    int k = atoi(c.ks.itens[ki]);
+                    int paralelismo = atoi(niveis->itens[p]);
+                    if (strcmp(motor, "serial") == 0 && p > 0) {
+                        break;
+                    }
+                    if (strcmp(motor, "serial") == 0) {
+                        paralelismo = 1;
+                    }
+                    char comando[MAX_COMANDO];
+                    if (!montar_comando(&c, motor, c.datasets.itens[d], k, paralelismo, comando)) {
+                        fprintf(stderr, "Motor desconhecido: %s\n", motor);
+                        return 1;
+                    }
+
+                    for (int i = 0; i < c.aquecimento; i++) {
+                        executar(comando);
+                    }
+                    Resultado* r = &resultados[n++];
+                    snprintf(r->motor, sizeof(r->motor), "%s", motor);
+                    snprintf(r->dataset, sizeof(r->dataset), "%s", c.datasets.itens[d]);
+                    r->k = k;
+                    r->paralelismo = paralelismo;
+                    r->repeticoes = c.repeticoes;
+                    r->amostras = (Amostra*)malloc(c.repeticoes * sizeof(Amostra));
+                    r->cliques = -1;
+                    r->consistente = true;
+                    r->esperado = contagem_esperada(c.referencias, r->dataset, k);
+                    r->linha_base = c.linha_base != NULL ? mediana_da_linha_base(c.linha_base, r) : NAN;
+                    for (int i = 0; i < c.repeticoes; i++) {
+                        r->amostras[i] = executar(comando);
+                        if (!r->amostras[i].ok) {
+                            r->falhas++;
+                            continue;
+                        }
+                        if (r->cliques == -1) {
+                            r->cliques = r->amostras[i].cliques;
+                        } else if (r->cliques != r->amostras[i].cliques) {
+                            r->consistente = false;
+                        }
+                    }
+
+                    Estatistica carga = estatistica(r, 0);
+                    Estatistica preproc = estatistica(r, 1);
+                    Estatistica contagem = estatistica(r, 2);
+                    Estatistica resposta = estatistica(r, 3);
+                    char avisos[256] = "";
+                    if (r->falhas > 0) {
+                        strcat(avisos, "  (falhas)");
+                    }
+                    if (!r->consistente) {
+                        strcat(avisos, "  (contagens divergem)");
+                    }
+                    if (r->esperado >= 0 && r->cliques != r->esperado) {
+                        snprintf(avisos + strlen(avisos), sizeof(avisos) - strlen(avisos),
+                                 "  (ERRADO: esperado %lld)", r->esperado);
+                    }
+                    if (!isnan(r->linha_base) && contagem.mediana > r->linha_base * c.limite) {
+                        snprintf(avisos + strlen(avisos), sizeof(avisos) - strlen(avisos),
+                                 "  (LENTO: %.2fx a linha de base)", contagem.mediana / r->linha_base);
+                    }
+                    printf("%-8s %-12s %3d %4d %12lld %12.6f %12.6f %12.6f %12.6f %12.6f%s\n",
+                           motor, r->dataset, k, paralelismo, r->cliques, carga.mediana,
+                           preproc.mediana, contagem.mediana, contagem.p90, resposta.mediana, avisos);
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    calcular_bases(resultados, n);
+    if (c.csv != NULL) {
+        escrever_csv(c.csv, resultados, n);
+    }
+    if (c.json != NULL) {
+        escrever_json(c.json, resultados, n);
+    }
+
+    // Sem referência, os motores ainda precisam concordar entre si.
+    int erros = 0, lentos = 0;
+    for (int i = 0; i < n; i++) {
+        Resultado* r = &resultados[i];
+        bool errado = r->falhas > 0 || !r->consistente || (r->esperado >= 0 && r->cliques != r->esperado);
+        for (int j = 0; j < i && !errado; j++) {
+            Resultado* outro = &resultados[j];
+            if (strcmp(outro->dataset, r->dataset) == 0 && outro->k == r->k && outro->falhas == 0
+                && outro->cliques != r->cliques) {
+                printf("Divergência: %s/%d = %lld em %s (%d), %lld em %s (%d)\n", r->dataset, r->k,
+                       r->cliques, r->motor, r->paralelismo, outro->cliques, outro->motor, outro->paralelismo);
+                errado = true;
+            }
+        }
+        erros += errado;
+        lentos += !isnan(r->linha_base) && estatistica(r, 2).mediana > r->linha_base * c.limite;
+        free(r->amostras);
+    }
+    free(resultados);
+    printf("%d configurações, %d com contagem errada ou falha, %d mais lentas que a linha de base (limite %.2fx)\n",
+           n, erros, lentos, c.limite);
+    return erros > 0 ? 1 : lentos > 0 ? 2 : 0;
+}
@@ -1,9 +1,20 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <pthread.h>
 #include <time.h>
+#include <stdint.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <linux/perf_event.h>
 
 typedef struct Nodo {
     int vertice;
@@ -15,186 +26,2309 @@ typedef struct Grafo {
     Nodo** adj;
 } Grafo;
 
+// Cópia somente leitura do grafo em vetores ordenados (sem repetições), usada
+// na contagem. Pode haver uma réplica por nó NUMA.
+typedef struct GrafoCSR {
+    int V;
+    int64_t* inicio;
+    int* grau;
+    int* vizinhos;
+} GrafoCSR;
+
+// Tipo das contagens de cliques: 64 bits sem sinal; com -DCONTAGEM_128,
+// 128 bits (o printf não formata esse tipo, daí formatar_contagem).
+#ifdef CONTAGEM_128
+typedef unsigned __int128 contagem_t;
+#else
+typedef uint64_t contagem_t;
+#endif
+
+const char* formatar_contagem(contagem_t c, char* texto) {
+    char invertido[48];
+    int n = 0;
+    do {
+        invertido[n++] = (char)('0' + (int)(c % 10));
+        c /= 10;
+    } while (c > 0);
+    for (int i = 0; i < n; i++) {
+        texto[i] = invertido[n - 1 - i];
+    }
+    texto[n] = '\0';
+    return texto;
+}
+
+// Acumulador por thread em linha de cache própria, escrito uma vez no fim.
+typedef struct ContadorThread {
+    contagem_t valor;
+} __attribute__((aligned(64))) ContadorThread;
+
 typedef struct Lista {
     int* vertices;
     int tamanho;
     struct Lista* prox;
 } Lista;
 
-typedef struct ThreadData {
-    Grafo* g;
-    int k;
-    int* contador;
-    Lista** cliques;
-    pthread_mutex_t* mutex;
-    Lista** trabalhos_geral;
-    int thread_id;
-    bool ativo;
-    Lista* fila_trabalhos;
-} ThreadData;
+// Perfil com contadores de hardware (--perf). Carga e pré-processamento são
+// medidos na thread principal com herança (as threads de preparo somam ao
+// terminar); na contagem, cada thread abre os próprios contadores. Sem
+// suporte (contêiner sem PMU, perf_event_paranoid), o perfil é desligado com
+// um aviso.
+#define NUM_EVENTOS_HW 5
+
+typedef struct ContadoresHW {
+    int fd[NUM_EVENTOS_HW];
+    uint64_t valor[NUM_EVENTOS_HW];
+    long long quadros;
+    int erro;
+} ContadoresHW;
+
+enum { HW_CICLOS, HW_INSTRUCOES, HW_FALHAS_LLC, HW_FALHAS_DESVIO, HW_FALHAS_DTLB };
+
+static int abrir_evento_hw(uint32_t tipo, uint64_t config, bool herdar) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = tipo;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = herdar;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// Abre os contadores da thread chamadora; devolve quantos abriram.
+int abrir_contadores_hw(ContadoresHW* c, bool herdar) {
+    const uint64_t leitura_falha = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const uint32_t tipos[NUM_EVENTOS_HW] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                            PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+    const uint64_t configs[NUM_EVENTOS_HW] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                              PERF_COUNT_HW_CACHE_LL | leitura_falha, PERF_COUNT_HW_BRANCH_MISSES,
+                                              PERF_COUNT_HW_CACHE_DTLB | leitura_falha};
+    int abertos = 0;
+    c->erro = 0;
+    for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+        c->valor[e] = 0;
+        c->fd[e] = abrir_evento_hw(tipos[e], configs[e], herdar);
+        if (c->fd[e] >= 0) {
+            abertos++;
+        } else if (c->erro == 0) {
+            c->erro = errno;
+        }
+    }
+    return abertos;
+}
+
+void ligar_contadores_hw(ContadoresHW* c) {
+    for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+        if (c->fd[e] >= 0) {
+            ioctl(c->fd[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(c->fd[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+// Lê os valores (escalados se houve multiplexação) e desliga os contadores.
+void desligar_contadores_hw(ContadoresHW* c) {
+    for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+        c->valor[e] = 0;
+        if (c->fd[e] < 0) {
+            continue;
+        }
+        ioctl(c->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t leitura[3];
+        if (read(c->fd[e], leitura, sizeof(leitura)) == sizeof(leitura) && leitura[2] > 0) {
+            c->valor[e] = (uint64_t)((double)leitura[0] * leitura[1] / leitura[2]);
+        }
+    }
+}
+
+void fechar_contadores_hw(ContadoresHW* c) {
+    for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+        if (c->fd[e] >= 0) {
+            close(c->fd[e]);
+            c->fd[e] = -1;
+        }
+    }
+}
+
+void imprimir_contadores_hw(const char* rotulo, ContadoresHW* c, long long quadros) {
+    const char* nomes[NUM_EVENTOS_HW] = {"ciclos", "instruções", "falhas LLC", "falhas de desvio", "falhas dTLB"};
+    printf("%s:", rotulo);
+    for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+        if (c->fd[e] >= 0) {
+            printf(" %s %llu,", nomes[e], (unsigned long long)c->valor[e]);
+        } else {
+            printf(" %s n/d,", nomes[e]);
+        }
+    }
+    if (c->fd[HW_CICLOS] >= 0 && c->fd[HW_INSTRUCOES] >= 0 && c->valor[HW_CICLOS] > 0) {
+        printf(" IPC %.3f", (double)c->valor[HW_INSTRUCOES] / c->valor[HW_CICLOS]);
+    } else {
+        printf(" IPC n/d");
+    }
+    if (quadros > 0) {
+        printf(", quadros %lld\n    por quadro expandido:", quadros);
+        const char* separador = "";
+        for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+            if (c->fd[e] >= 0) {
+                printf("%s %s %.3f", separador, nomes[e], (double)c->valor[e] / quadros);
+                separador = ",";
+            }
+        }
+    }
+    printf("\n");
+}
+
+// Contadores da busca por thread, compilados só com -DINSTRUMENTAR e somados
+// no fim. Com --trace, os intervalos ocupado/ocioso e os roubos de cada
+// thread são gravados no formato de trilha do Chrome (chrome://tracing).
+static inline double agora(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+#ifdef INSTRUMENTAR
+#define INSTR(x) x
+#define MAX_PROFUNDIDADE 32
+#define MAX_EVENTOS (1 << 20)
+
+typedef struct EventoTrilha {
+    const char* nome;
+    double inicio;
+    double fim;
+} EventoTrilha;
+
+typedef struct Instrumentacao {
+    uint64_t quadros[MAX_PROFUNDIDADE];
+    uint64_t candidatos;
+    uint64_t sondagens;
+    uint64_t alocacoes;
+    uint64_t roubos_ok;
+    uint64_t roubos_falhos;
+    uint64_t tarefas_roubadas;
+    double ocupado;
+    double ocioso;
+    EventoTrilha* eventos;
+    int num_eventos;
+} __attribute__((aligned(64))) Instrumentacao;
+
+Instrumentacao* instrumentacao = NULL;
+double origem_trilha;
+static __thread Instrumentacao* instr_thread = NULL;
+
+// Intervalos ocupado/ocioso vão para o tempo total; com trilha, também viram
+// eventos ("roubo" tem duração zero).
+void registrar_evento(const char* nome, double inicio, double fim) {
+    Instrumentacao* in = instr_thread;
+    if (strcmp(nome, "ocupado") == 0) {
+        in->ocupado += fim - inicio;
+    } else if (strcmp(nome, "ocioso") == 0) {
+        in->ocioso += fim - inicio;
+    }
+    if (in->eventos != NULL && in->num_eventos < MAX_EVENTOS) {
+        in->eventos[in->num_eventos].nome = nome;
+        in->eventos[in->num_eventos].inicio = inicio;
+        in->eventos[in->num_eventos].fim = fim;
+        in->num_eventos++;
+    }
+}
+
+void iniciar_instrumentacao(int num_threads, bool trilha) {
+    instrumentacao = (Instrumentacao*)aligned_alloc(64, num_threads * sizeof(Instrumentacao));
+    memset(instrumentacao, 0, num_threads * sizeof(Instrumentacao));
+    for (int t = 0; t < num_threads && trilha; t++) {
+        instrumentacao[t].eventos = (EventoTrilha*)malloc(MAX_EVENTOS * sizeof(EventoTrilha));
+    }
+    origem_trilha = agora();
+}
+
+void gravar_trilha(const char* arquivo, int num_threads) {
+    FILE* f = fopen(arquivo, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Erro ao criar %s\n", arquivo);
+        return;
+    }
+    fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (int t = 0; t < num_threads; t++) {
+        fprintf(f, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}},\n", t, t);
+    }
+    bool primeiro = true;
+    for (int t = 0; t < num_threads; t++) {
+        Instrumentacao* in = &instrumentacao[t];
+        for (int e = 0; e < in->num_eventos; e++) {
+            EventoTrilha* ev = &in->eventos[e];
+            if (strcmp(ev->nome, "roubo") == 0) {
+                fprintf(f, "%s{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f}",
+                        primeiro ? "" : ",\n", ev->nome, t, (ev->inicio - origem_trilha) * 1e6);
+            } else {
+                fprintf(f, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                        primeiro ? "" : ",\n", ev->nome, t, (ev->inicio - origem_trilha) * 1e6,
+                        (ev->fim - ev->inicio) * 1e6);
+            }
+            primeiro = false;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    printf("Trilha gravada em %s\n", arquivo);
+}
+
+void relatar_instrumentacao(int num_threads, const char* trilha) {
+    Instrumentacao soma;
+    memset(&soma, 0, sizeof(soma));
+    printf("Instrumentação (%d threads):\n", num_threads);
+    for (int t = 0; t < num_threads; t++) {
+        Instrumentacao* in = &instrumentacao[t];
+        uint64_t quadros = 0;
+        for (int d = 0; d < MAX_PROFUNDIDADE; d++) {
+            soma.quadros[d] += in->quadros[d];
+            quadros += in->quadros[d];
+        }
+        soma.candidatos += in->candidatos;
+        soma.sondagens += in->sondagens;
+        soma.alocacoes += in->alocacoes;
+        soma.roubos_ok += in->roubos_ok;
+        soma.roubos_falhos += in->roubos_falhos;
+        soma.tarefas_roubadas += in->tarefas_roubadas;
+        printf("  Thread %d: ocupado %.6f s, ocioso %.6f s, quadros %llu, candidatos %llu, sondagens %llu, "
+               "alocações %llu, roubos %llu ok / %llu falhos (%llu tarefas)\n",
+               t, in->ocupado, in->ocioso, (unsigned long long)quadros,
+               (unsigned long long)in->candidatos, (unsigned long long)in->sondagens,
+               (unsigned long long)in->alocacoes, (unsigned long long)in->roubos_ok,
+               (unsigned long long)in->roubos_falhos, (unsigned long long)in->tarefas_roubadas);
+    }
+    printf("  Quadros por profundidade:");
+    for (int d = 0; d < MAX_PROFUNDIDADE; d++) {
+        if (soma.quadros[d] > 0) {
+            printf(" %d:%llu", d, (unsigned long long)soma.quadros[d]);
+        }
+    }
+    printf("\n  Total: candidatos %llu, sondagens %llu, alocações %llu, roubos %llu ok / %llu falhos (%llu tarefas)\n",
+           (unsigned long long)soma.candidatos, (unsigned long long)soma.sondagens,
+           (unsigned long long)soma.alocacoes, (unsigned long long)soma.roubos_ok,
+           (unsigned long long)soma.roubos_falhos, (unsigned long long)soma.tarefas_roubadas);
+    if (trilha != NULL) {
+        gravar_trilha(trilha, num_threads);
+    }
+    for (int t = 0; t < num_threads; t++) {
+        free(instrumentacao[t].eventos);
+    }
+    free(instrumentacao);
+}
+#else
+#define INSTR(x)
+#endif
+
+typedef struct ThreadData {
+    GrafoCSR* g;
+    int k;
+    ContadorThread* contador;
+    Lista** cliques;
+    pthread_mutex_t* mutex;
+    int thread_id;
+    int num_threads;
+    int no;
+    int cpu;
+    int maxv;
+    struct ThreadData* todas;
+    int* ativos;
+    long long quadros;
+    ContadoresHW* hw;
+    struct Pipeline* pipeline;
+#ifdef INSTRUMENTAR
+    Instrumentacao* instr;
+#endif
+} ThreadData;
+
+bool conexao_completa(GrafoCSR* g, int* clique, int tamanho, int vizinho);
+bool montar_proxima_faixa(ThreadData* data);
+void ler_trecho_pipeline(struct Pipeline* pl, int i);
+
+Nodo* criar_nodo(int vertice) {
+    Nodo* novo_nodo = (Nodo*)malloc(sizeof(Nodo));
+    novo_nodo->vertice = vertice;
+    novo_nodo->prox = NULL;
+    return novo_nodo;
+}
+
+Grafo* criar_grafo(int V) {
+    Grafo* g = (Grafo*)malloc(sizeof(Grafo));
+    g->V = V;
+    g->adj = (Nodo**)malloc(V * sizeof(Nodo*));
+    for (int i = 0; i < V; i++) {
+        g->adj[i] = NULL;
+    }
+    return g;
+}
+
+void adicionar_aresta(Grafo* g, int u, int v) {
+    Nodo* novo_nodo_v = criar_nodo(v);
+    novo_nodo_v->prox = g->adj[u];
+    g->adj[u] = novo_nodo_v;
+
+    Nodo* novo_nodo_u = criar_nodo(u);
+    novo_nodo_u->prox = g->adj[v];
+    g->adj[v] = novo_nodo_u;
+}
+
+// Tira até "maxv" itens do topo da pilha de uma vítima, preferindo threads do
+// mesmo nó NUMA. Devolve o primeiro; o resto vai para a pilha de quem roubou.
+Lista* roubar_trabalho(ThreadData* dados, int maxv) {
+    for (int passo = 0; passo < 2; passo++) {
+        for (int d = 1; d < dados->num_threads; d++) {
+            ThreadData* vitima = &dados->todas[(dados->thread_id + d) % dados->num_threads];
+            if ((passo == 0) != (vitima->no == dados->no)) {
+                continue;
+            }
+            pthread_mutex_lock(vitima->mutex);
+            Lista* item = *vitima->cliques;
+            if (item == NULL) {
+                pthread_mutex_unlock(vitima->mutex);
+                continue;
+            }
+            Lista* ultimo = item;
+            int quantos = 1;
+            for (; quantos < maxv && ultimo->prox != NULL; quantos++) {
+                ultimo = ultimo->prox;
+            }
+            INSTR(instr_thread->roubos_ok++);
+            INSTR(instr_thread->tarefas_roubadas += quantos);
+            *vitima->cliques = ultimo->prox;
+            ultimo->prox = NULL;
+            // Volta a contar como ativa antes de soltar a vítima, para que
+            // nenhuma thread conclua que o trabalho acabou.
+            __atomic_add_fetch(dados->ativos, 1, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(vitima->mutex);
+
+            if (item->prox != NULL) {
+                pthread_mutex_lock(dados->mutex);
+                ultimo->prox = *dados->cliques;
+                *dados->cliques = item->prox;
+                pthread_mutex_unlock(dados->mutex);
+            }
+            item->prox = NULL;
+            return item;
+        }
+    }
+    INSTR(instr_thread->roubos_falhos++);
+    return NULL;
+}
+
+void fixar_thread(int cpu) {
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    CPU_SET(cpu, &conjunto);
+    pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto);
+}
+
+// Vizinhos de "v" com ID maior que "v".
+const int* candidatos_apos(GrafoCSR* g, int v, int* n) {
+    int64_t fim = g->inicio[v] + g->grau[v];
+    int64_t lo = g->inicio[v], hi = fim;
+    while (lo < hi) {
+        int64_t meio = (lo + hi) >> 1;
+        if (g->vizinhos[meio] <= v) {
+            lo = meio + 1;
+        } else {
+            hi = meio;
+        }
+    }
+    *n = (int)(fim - lo);
+    return g->vizinhos + lo;
+}
+
+void* contagem_de_cliques_thread(void* arg) {
+    ThreadData* data = (ThreadData*)arg;
+    GrafoCSR* g = data->g;
+    int k = data->k;
+    contagem_t contador = 0;
+    Lista** cliques = data->cliques;
+    pthread_mutex_t* mutex = data->mutex;
+
+    fixar_thread(data->cpu);
+    long long quadros = 0;
+    if (data->hw != NULL) {
+        abrir_contadores_hw(data->hw, false);
+        ligar_contadores_hw(data->hw);
+    }
+#ifdef INSTRUMENTAR
+    instr_thread = data->instr;
+    double inicio_ocupado = agora();
+#endif
+    if (data->pipeline != NULL) {
+        ler_trecho_pipeline(data->pipeline, data->thread_id);
+    }
+
+    while (true) {
+        pthread_mutex_lock(mutex);
+        Lista* clique_atual = *cliques;
+        if (clique_atual != NULL) {
+            *cliques = clique_atual->prox;
+        }
+        pthread_mutex_unlock(mutex);
+
+        // Em pipeline, sem trabalho próprio, monta a próxima faixa antes de
+        // roubar (e continua ativa enquanto isso).
+        if (clique_atual == NULL && data->pipeline != NULL && montar_proxima_faixa(data)) {
+            continue;
+        }
+
+        if (clique_atual == NULL) {
+#ifdef INSTRUMENTAR
+            double inicio_ocioso = agora();
+            registrar_evento("ocupado", inicio_ocupado, inicio_ocioso);
+#endif
+            __atomic_sub_fetch(data->ativos, 1, __ATOMIC_SEQ_CST);
+            while (clique_atual == NULL) {
+                clique_atual = roubar_trabalho(data, data->maxv);
+                if (clique_atual == NULL) {
+                    if (__atomic_load_n(data->ativos, __ATOMIC_SEQ_CST) == 0) {
+                        INSTR(registrar_evento("ocioso", inicio_ocioso, agora()));
+                        if (data->hw != NULL) {
+                            desligar_contadores_hw(data->hw);
+                        }
+                        data->quadros = quadros;
+                        data->contador->valor = contador;
+                        return NULL;
+                    }
+                    sched_yield();
+                }
+            }
+#ifdef INSTRUMENTAR
+            inicio_ocupado = agora();
+            registrar_evento("ocioso", inicio_ocioso, inicio_ocupado);
+            registrar_evento("roubo", inicio_ocupado, inicio_ocupado);
+#endif
+        }
+
+        if (clique_atual->tamanho == k) {
+            contador++;
+            free(clique_atual->vertices);
+            free(clique_atual);
+            continue;
+        }
+
+        int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
+        quadros++;
+
+        int num_candidatos;
+        const int* candidatos = candidatos_apos(g, ultimo_vertice, &num_candidatos);
+        INSTR(instr_thread->quadros[clique_atual->tamanho < MAX_PROFUNDIDADE ? clique_atual->tamanho : MAX_PROFUNDIDADE - 1]++);
+        INSTR(instr_thread->candidatos += num_candidatos);
+        Lista* filhos = NULL;
+        for (int c = 0; c < num_candidatos; c++) {
+            int vizinho = candidatos[c];
+            if (conexao_completa(g, clique_atual->vertices, clique_atual->tamanho - 1, vizinho)) {
+                int* nova_clique = malloc((clique_atual->tamanho + 1) * sizeof(int));
+                memcpy(nova_clique, clique_atual->vertices, clique_atual->tamanho * sizeof(int));
+                nova_clique[clique_atual->tamanho] = vizinho;
+
+                Lista* nova_lista = malloc(sizeof(Lista));
+                INSTR(instr_thread->alocacoes += 2);
+                nova_lista->vertices = nova_clique;
+                nova_lista->tamanho = clique_atual->tamanho + 1;
+                nova_lista->prox = filhos;
+                filhos = nova_lista;
+            }
+        }
+        if (filhos != NULL) {
+            Lista* ultimo = filhos;
+            while (ultimo->prox != NULL) {
+                ultimo = ultimo->prox;
+            }
+            pthread_mutex_lock(mutex);
+            ultimo->prox = *cliques;
+            *cliques = filhos;
+            pthread_mutex_unlock(mutex);
+        }
+
+        free(clique_atual->vertices);
+        free(clique_atual);
+    }
+    return NULL;
+}
+
+// CPUs permitidas ao processo agrupadas por nó NUMA, lidas de
+// /sys/devices/system/node. Sem essa informação, tudo fica no nó 0.
+typedef struct Topologia {
+    int num_nos;
+    int num_cpus;
+    int* cpus;
+    int* no;
+} Topologia;
+
+Topologia* detectar_topologia(void) {
+    cpu_set_t permitidas;
+    CPU_ZERO(&permitidas);
+    if (sched_getaffinity(0, sizeof(permitidas), &permitidas) != 0) {
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            CPU_SET(c, &permitidas);
+        }
+    }
+    Topologia* t = (Topologia*)calloc(1, sizeof(Topologia));
+    t->cpus = (int*)malloc(CPU_SETSIZE * sizeof(int));
+    t->no = (int*)malloc(CPU_SETSIZE * sizeof(int));
+    bool vista[CPU_SETSIZE];
+    memset(vista, 0, sizeof(vista));
+
+    for (int n = 0; n < 1024; n++) {
+        char caminho[96];
+        snprintf(caminho, sizeof(caminho), "/sys/devices/system/node/node%d/cpulist", n);
+        FILE* f = fopen(caminho, "r");
+        if (f == NULL) {
+            if (n > 0 && t->num_nos > 0) {
+                break;
+            }
+            continue;
+        }
+        int antes = t->num_cpus;
+        int a, b;
+        char sep;
+        while (fscanf(f, "%d", &a) == 1) {
+            b = a;
+            if (fscanf(f, "%c", &sep) == 1 && sep == '-') {
+                if (fscanf(f, "%d", &b) != 1) {
+                    break;
+                }
+                if (fscanf(f, "%c", &sep) != 1) {
+                    sep = '\n';
+                }
+            }
+            for (int c = a; c <= b && c < CPU_SETSIZE; c++) {
+                if (CPU_ISSET(c, &permitidas) && !vista[c]) {
+                    vista[c] = true;
+                    t->cpus[t->num_cpus] = c;
+                    t->no[t->num_cpus] = t->num_nos;
+                    t->num_cpus++;
+                }
+            }
+            if (sep != ',') {
+                break;
+            }
+        }
+        fclose(f);
+        if (t->num_cpus > antes) {
+            t->num_nos++;
+        }
+    }
+    if (t->num_cpus == 0) {
+        t->num_nos = 1;
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &permitidas)) {
+                t->cpus[t->num_cpus] = c;
+                t->no[t->num_cpus] = 0;
+                t->num_cpus++;
+            }
+        }
+    }
+    return t;
+}
+
+void liberar_topologia(Topologia* t) {
+    free(t->cpus);
+    free(t->no);
+    free(t);
+}
+
+// Índice em t->cpus para a thread "i". "compacta" preenche um nó antes de
+// passar ao próximo; "espalhada" alterna entre os nós.
+int posicao_cpu(Topologia* t, const char* politica, int i) {
+    if (strcmp(politica, "espalhada") != 0 || t->num_nos == 1) {
+        return i % t->num_cpus;
+    }
+    int no = i % t->num_nos;
+    int ordem = i / t->num_nos;
+    int cpus_no = 0;
+    for (int c = 0; c < t->num_cpus; c++) {
+        if (t->no[c] == no) {
+            cpus_no++;
+        }
+    }
+    ordem %= cpus_no;
+    for (int c = 0; c < t->num_cpus; c++) {
+        if (t->no[c] == no && ordem-- == 0) {
+            return c;
+        }
+    }
+    return i % t->num_cpus;
+}
+
+// Aloca um vetor grande do grafo. Com "paginas_grandes", alinha em 2 MB e
+// pede páginas enormes transparentes (THP) para reduzir falhas de TLB.
+void* alocar_grande(size_t bytes, bool paginas_grandes) {
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    if (!paginas_grandes) {
+        return malloc(bytes);
+    }
+    size_t alinhamento = 2 * 1024 * 1024;
+    size_t tamanho = (bytes + alinhamento - 1) / alinhamento * alinhamento;
+    void* p = NULL;
+    if (posix_memalign(&p, alinhamento, tamanho) != 0) {
+        return malloc(bytes);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(p, tamanho, MADV_HUGEPAGE);
+#endif
+    return p;
+}
+
+int comparar_int(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Reserva o CSR com espaço para a lista encadeada inteira de cada vértice;
+// as listas são preenchidas depois, pelas threads de preparo.
+GrafoCSR* criar_grafo_csr(Grafo* g, bool paginas_grandes) {
+    GrafoCSR* c = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+    c->V = g->V;
+    c->inicio = (int64_t*)malloc((g->V + 1) * sizeof(int64_t));
+    c->grau = (int*)alocar_grande(g->V * sizeof(int), paginas_grandes);
+    c->inicio[0] = 0;
+    for (int v = 0; v < g->V; v++) {
+        int n = 0;
+        for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+            n++;
+        }
+        c->inicio[v + 1] = c->inicio[v] + n;
+    }
+    c->vizinhos = (int*)alocar_grande(c->inicio[g->V] * sizeof(int), paginas_grandes);
+    return c;
+}
+
+// Réplica com os mesmos deslocamentos; o conteúdo é copiado pelas threads
+// do nó dono.
+GrafoCSR* criar_replica_csr(GrafoCSR* origem, bool paginas_grandes) {
+    GrafoCSR* c = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+    c->V = origem->V;
+    c->inicio = (int64_t*)malloc((c->V + 1) * sizeof(int64_t));
+    memcpy(c->inicio, origem->inicio, (c->V + 1) * sizeof(int64_t));
+    c->grau = (int*)alocar_grande(c->V * sizeof(int), paginas_grandes);
+    c->vizinhos = (int*)alocar_grande(c->inicio[c->V] * sizeof(int), paginas_grandes);
+    return c;
+}
+
+// Ordena a lista e tira as repetições; devolve o novo tamanho.
+int ordenar_sem_repeticoes(int* lista, int n) {
+    qsort(lista, n, sizeof(int), comparar_int);
+    int unicos = 0;
+    for (int i = 0; i < n; i++) {
+        if (unicos == 0 || lista[unicos - 1] != lista[i]) {
+            lista[unicos++] = lista[i];
+        }
+    }
+    return unicos;
+}
+
+// Copia, ordena e remove laços e repetições dos vértices [de, ate).
+void preencher_csr(GrafoCSR* c, Grafo* g, int de, int ate) {
+    for (int v = de; v < ate; v++) {
+        int* lista = c->vizinhos + c->inicio[v];
+        int n = 0;
+        for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+            if (adj->vertice != v) {
+                lista[n++] = adj->vertice;
+            }
+        }
+        c->grau[v] = ordenar_sem_repeticoes(lista, n);
+    }
+}
+
+void liberar_grafo_csr(GrafoCSR* c) {
+    free(c->inicio);
+    free(c->grau);
+    free(c->vizinhos);
+    free(c);
+}
+
+typedef struct Preparo {
+    GrafoCSR* csr;
+    GrafoCSR* origem;
+    Grafo* g;
+    int de;
+    int ate;
+    int cpu;
+} Preparo;
+
+// Roda fixada na mesma CPU que a thread de contagem correspondente, para que
+// a primeira escrita de cada página do CSR aconteça no nó NUMA dela.
+void* preparar_faixa(void* arg) {
+    Preparo* p = (Preparo*)arg;
+    fixar_thread(p->cpu);
+    if (p->origem == NULL) {
+        preencher_csr(p->csr, p->g, p->de, p->ate);
+    } else {
+        memcpy(p->csr->grau + p->de, p->origem->grau + p->de, (p->ate - p->de) * sizeof(int));
+        memcpy(p->csr->vizinhos + p->csr->inicio[p->de], p->origem->vizinhos + p->origem->inicio[p->de],
+               (p->csr->inicio[p->ate] - p->csr->inicio[p->de]) * sizeof(int));
+    }
+    return NULL;
+}
+
+// Opções de execução NUMA: fixação das threads, réplica por nó e THP.
+typedef struct ConfigNuma {
+    const char* afinidade;
+    bool replicar;
+    bool paginas_grandes;
+} ConfigNuma;
+
+// Executa preparar_faixa em "t" threads, dividindo [0, V) em faixas contíguas.
+void preparar_em_paralelo(GrafoCSR* csr, GrafoCSR* origem, Grafo* g, int t, int* cpus) {
+    pthread_t threads[t];
+    Preparo preparos[t];
+    int V = csr->V;
+    for (int i = 0; i < t; i++) {
+        preparos[i].csr = csr;
+        preparos[i].origem = origem;
+        preparos[i].g = g;
+        preparos[i].de = (int)((int64_t)V * i / t);
+        preparos[i].ate = (int)((int64_t)V * (i + 1) / t);
+        preparos[i].cpu = cpus == NULL ? -1 : cpus[i];
+        pthread_create(&threads[i], NULL, preparar_faixa, &preparos[i]);
+    }
+    for (int i = 0; i < t; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// Grafo pronto para a contagem: CSR (e réplicas por nó) e a CPU/nó de cada
+// thread.
+typedef struct GrafoPreparado {
+    int V;
+    int t;
+    int* cpus;
+    int* nos;
+    int num_replicas;
+    GrafoCSR** replicas;
+} GrafoPreparado;
+
+GrafoPreparado* preparar_grafo(Grafo* g, int t, ConfigNuma* config) {
+    GrafoPreparado* p = (GrafoPreparado*)malloc(sizeof(GrafoPreparado));
+    p->V = g->V;
+    p->t = t;
+    p->cpus = (int*)malloc(t * sizeof(int));
+    p->nos = (int*)malloc(t * sizeof(int));
+
+    Topologia* topologia = detectar_topologia();
+    bool fixar = config->afinidade != NULL && strcmp(config->afinidade, "nenhuma") != 0;
+    for (int i = 0; i < t; i++) {
+        int c = posicao_cpu(topologia, fixar ? config->afinidade : "compacta", i);
+        p->cpus[i] = fixar ? topologia->cpus[c] : -1;
+        p->nos[i] = fixar ? topologia->no[c] : 0;
+    }
+
+    // O CSR principal é preenchido pelas próprias threads de contagem; com
+    // réplicas, cada nó recebe uma cópia feita pelas threads dele.
+    GrafoCSR* principal = criar_grafo_csr(g, config->paginas_grandes);
+    preparar_em_paralelo(principal, NULL, g, t, fixar ? p->cpus : NULL);
+
+    p->num_replicas = (config->replicar && fixar) ? topologia->num_nos : 1;
+    p->replicas = (GrafoCSR**)malloc(p->num_replicas * sizeof(GrafoCSR*));
+    p->replicas[0] = principal;
+    for (int n = 1; n < p->num_replicas; n++) {
+        int cpus_no[t];
+        int quantas = 0;
+        for (int i = 0; i < t; i++) {
+            if (p->nos[i] == n) {
+                cpus_no[quantas++] = p->cpus[i];
+            }
+        }
+        if (quantas == 0) {
+            p->replicas[n] = principal;
+            continue;
+        }
+        p->replicas[n] = criar_replica_csr(principal, config->paginas_grandes);
+        preparar_em_paralelo(p->replicas[n], principal, g, quantas, cpus_no);
+    }
+    if (fixar) {
+        printf("Afinidade %s: %d threads em %d CPUs, %d nós NUMA, %d réplica(s) do grafo\n",
+               config->afinidade, t, topologia->num_cpus, topologia->num_nos, p->num_replicas);
+    }
+    liberar_topologia(topologia);
+    return p;
+}
+
+void liberar_grafo_preparado(GrafoPreparado* p) {
+    for (int n = 1; n < p->num_replicas; n++) {
+        if (p->replicas[n] != p->replicas[0]) {
+            liberar_grafo_csr(p->replicas[n]);
+        }
+    }
+    liberar_grafo_csr(p->replicas[0]);
+    free(p->replicas);
+    free(p->cpus);
+    free(p->nos);
+    free(p);
+}
+
+// Quadros (cliques parciais) expandidos na última contagem.
+long long quadros_expandidos = 0;
+
+// Com "perfil" (um ContadoresHW por thread), cada thread mede a própria
+// contagem.
+contagem_t contagem_de_cliques_paralela(GrafoPreparado* p, int k, int maxv, ContadoresHW* perfil) {
+    int t = p->t;
+    pthread_t threads[t];
+    ThreadData dados[t];
+    ContadorThread contadores[t];
+    pthread_mutex_t mutexes[t];
+    Lista* trabalho_por_thread[t];
+    int ativos = t;
+
+    for (int i = 0; i < t; i++) {
+        contadores[i].valor = 0;
+        trabalho_por_thread[i] = NULL;
+        pthread_mutex_init(&mutexes[i], NULL);
+    }
+
+    // Raízes em faixas contíguas, a mesma divisão usada no preparo.
+    for (int i = 0; i < t; i++) {
+        int de = (int)((int64_t)p->V * i / t);
+        int ate = (int)((int64_t)p->V * (i + 1) / t);
+        for (int v = ate - 1; v >= de; v--) {
+            int* clique_inicial = malloc(sizeof(int));
+            clique_inicial[0] = v;
+            Lista* nova_lista = malloc(sizeof(Lista));
+            nova_lista->vertices = clique_inicial;
+            nova_lista->tamanho = 1;
+            nova_lista->prox = trabalho_por_thread[i];
+            trabalho_por_thread[i] = nova_lista;
+        }
+    }
+
+    for (int i = 0; i < t; i++) {
+        dados[i].g = p->replicas[p->nos[i] < p->num_replicas ? p->nos[i] : 0];
+        dados[i].k = k;
+        dados[i].contador = &contadores[i];
+        dados[i].cliques = &trabalho_por_thread[i];
+        dados[i].mutex = &mutexes[i];
+        dados[i].thread_id = i;
+        dados[i].num_threads = t;
+        dados[i].no = p->nos[i];
+        dados[i].cpu = p->cpus[i];
+        dados[i].maxv = maxv > 0 ? maxv : 1;
+        dados[i].todas = dados;
+        dados[i].ativos = &ativos;
+        dados[i].quadros = 0;
+        dados[i].hw = perfil != NULL ? &perfil[i] : NULL;
+        dados[i].pipeline = NULL;
+#ifdef INSTRUMENTAR
+        dados[i].instr = &instrumentacao[i];
+#endif
+    }
+    for (int i = 0; i < t; i++) {
+        pthread_create(&threads[i], NULL, contagem_de_cliques_thread, &dados[i]);
+    }
+
+    for (int i = 0; i < t; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    contagem_t total_contador = 0;
+    quadros_expandidos = 0;
+    for (int i = 0; i < t; i++) {
+        total_contador += contadores[i].valor;
+        quadros_expandidos += dados[i].quadros;
+        if (perfil != NULL) {
+            perfil[i].quadros = dados[i].quadros;
+        }
+        pthread_mutex_destroy(&mutexes[i]);
+    }
+
+    return total_contador;
+}
+
+// Modo de memória limitada (--memoria=MB). Nada é empilhado de antemão: cada
+// thread percorre a busca com uma pilha de no máximo k quadros, e cada
+// quadro é um iterador sobre o próprio conjunto de candidatos (interseção
+// dos candidatos do pai com os vizinhos maiores do vértice escolhido), que
+// gera um filho por vez. Os conjuntos ficam numa arena por thread de tamanho
+// fixo, calculado do maior grau orientado, então o pior caso cabe no
+// orçamento antes de a contagem começar. O trabalho é dividido em unidades
+// distribuídas por um contador atômico: uma por raiz ou, para raízes com
+// mais de LIMIAR_DIVISAO candidatos, uma por primeiro filho, para que hubs
+// não fiquem numa thread só.
+#define LIMIAR_DIVISAO 64
+#define BLOCO_UNIDADES 8
+
+typedef struct QuadroIterador {
+    const int* candidatos;
+    int n;
+    int proximo;
+    int limite;
+} QuadroIterador;
+
+typedef struct DadosLimitados {
+    GrafoCSR* g;
+    int k;
+    int cpu;
+    ContadorThread* contador;
+    int64_t* inicio_unidade;
+    int64_t* proxima_unidade;
+    int64_t ultima_unidade;
+    int* arena;
+    size_t capacidade_arena;
+    int largura;
+    int pico_quadros;
+    size_t pico_arena;
+    long long quadros;
+    ContadoresHW* hw;
+#ifdef INSTRUMENTAR
+    Instrumentacao* instr;
+#endif
+} DadosLimitados;
+
+// Escreve em "saida" os candidatos[0..n) que são vizinhos maiores de "w"
+// (saida == NULL só conta) e devolve quantos são.
+static int intersecao_maiores(GrafoCSR* g, int w, const int* candidatos, int n, int* saida) {
+    int nb;
+    const int* b = candidatos_apos(g, w, &nb);
+    int m = 0;
+    for (int i = 0, j = 0; i < n && j < nb;) {
+        if (candidatos[i] < b[j]) {
+            i++;
+        } else if (candidatos[i] > b[j]) {
+            j++;
+        } else {
+            if (saida != NULL) {
+                saida[m] = candidatos[i];
+            }
+            m++;
+            i++;
+            j++;
+        }
+    }
+    return m;
+}
+
+// Raiz dona da unidade "u" (busca binária nos inícios).
+static int raiz_da_unidade(int64_t* inicio_unidade, int V, int64_t u) {
+    int lo = 0, hi = V - 1;
+    while (lo < hi) {
+        int meio = (lo + hi + 1) >> 1;
+        if (inicio_unidade[meio] <= u) {
+            lo = meio;
+        } else {
+            hi = meio - 1;
+        }
+    }
+    return lo;
+}
+
+void* contagem_limitada_thread(void* arg) {
+    DadosLimitados* data = (DadosLimitados*)arg;
+    GrafoCSR* g = data->g;
+    int k = data->k;
+    contagem_t contador = 0;
+    long long quadros = 0;
+    QuadroIterador pilha[k > 1 ? k : 1];
+    size_t uso_arena = 0;
+
+    fixar_thread(data->cpu);
+    if (data->hw != NULL) {
+        abrir_contadores_hw(data->hw, false);
+        ligar_contadores_hw(data->hw);
+    }
+#ifdef INSTRUMENTAR
+    instr_thread = data->instr;
+    double inicio_ocupado = agora();
+#endif
+
+    int64_t total_unidades = data->ultima_unidade;
+    while (true) {
+        int64_t de = __atomic_fetch_add(data->proxima_unidade, BLOCO_UNIDADES, __ATOMIC_RELAXED);
+        if (de >= total_unidades) {
+            break;
+        }
+        int64_t ate = de + BLOCO_UNIDADES < total_unidades ? de + BLOCO_UNIDADES : total_unidades;
+        int v = raiz_da_unidade(data->inicio_unidade, g->V, de);
+        for (int64_t u = de; u < ate; u++) {
+            while (data->inicio_unidade[v + 1] <= u) {
+                v++;
+            }
+            if (k == 1) {
+                contador++;
+                continue;
+            }
+            int n;
+            const int* maiores = candidatos_apos(g, v, &n);
+            int64_t unidades = data->inicio_unidade[v + 1] - data->inicio_unidade[v];
+            int inicio = unidades > 1 ? (int)(u - data->inicio_unidade[v]) : 0;
+            int limite = unidades > 1 ? inicio + 1 : n;
+            if (k == 2) {
+                contador += limite - inicio;
+                continue;
+            }
+
+            quadros++;
+            INSTR(instr_thread->quadros[1]++);
+            INSTR(instr_thread->candidatos += n);
+            int topo = 0;
+            pilha[0].candidatos = maiores;
+            pilha[0].n = n;
+            pilha[0].proximo = inicio;
+            pilha[0].limite = limite;
+            if (data->pico_quadros == 0) {
+                data->pico_quadros = 1;
+            }
+            while (topo >= 0) {
+                QuadroIterador* q = &pilha[topo];
+                if (q->proximo >= q->limite) {
+                    if (topo > 0) {
+                        uso_arena -= q->n;
+                    }
+                    topo--;
+                    continue;
+                }
+                int w = q->candidatos[q->proximo++];
+                const int* restantes = q->candidatos + q->proximo;
+                int num_restantes = q->n - q->proximo;
+                // Clique com topo + 2 vértices; no penúltimo nível basta o
+                // tamanho da interseção.
+                if (topo + 3 == k) {
+                    contador += intersecao_maiores(g, w, restantes, num_restantes, NULL);
+                    continue;
+                }
+                if (uso_arena + num_restantes > data->capacidade_arena) {
+                    fprintf(stderr, "Arena da thread excedida (%zu de %zu)\n",
+                            uso_arena + num_restantes, data->capacidade_arena);
+                    exit(EXIT_FAILURE);
+                }
+                int* filhos = data->arena + uso_arena;
+                int m = intersecao_maiores(g, w, restantes, num_restantes, filhos);
+                if (m == 0) {
+                    continue;
+                }
+                uso_arena += m;
+                topo++;
+                quadros++;
+                INSTR(instr_thread->quadros[topo + 1 < MAX_PROFUNDIDADE ? topo + 1 : MAX_PROFUNDIDADE - 1]++);
+                INSTR(instr_thread->candidatos += m);
+                pilha[topo].candidatos = filhos;
+                pilha[topo].n = m;
+                pilha[topo].proximo = 0;
+                pilha[topo].limite = m;
+                if (topo + 1 > data->pico_quadros) {
+                    data->pico_quadros = topo + 1;
+                }
+                if (uso_arena > data->pico_arena) {
+                    data->pico_arena = uso_arena;
+                }
+            }
+        }
+    }
+
+    INSTR(registrar_evento("ocupado", inicio_ocupado, agora()));
+    if (data->hw != NULL) {
+        desligar_contadores_hw(data->hw);
+    }
+    data->quadros += quadros;
+    data->contador->valor += contador;
+    return NULL;
+}
+
+// Roda as threads do modo limitado sobre as unidades [de, ate).
+void rodar_unidades(DadosLimitados* dados, int t, int64_t de, int64_t ate) {
+    pthread_t threads[t];
+    int64_t proxima_unidade = de;
+    for (int i = 0; i < t; i++) {
+        dados[i].proxima_unidade = &proxima_unidade;
+        dados[i].ultima_unidade = ate;
+        pthread_create(&threads[i], NULL, contagem_limitada_thread, &dados[i]);
+    }
+    for (int i = 0; i < t; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// Pico de memória residente do processo (VmHWM), em KB; -1 se indisponível.
+long memoria_residente_maxima(void) {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (f == NULL) {
+        return -1;
+    }
+    char linha[256];
+    long kb = -1;
+    while (fgets(linha, sizeof(linha), f) != NULL) {
+        if (sscanf(linha, "VmHWM: %ld", &kb) == 1) {
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
+
+// Início de cada raiz na numeração das unidades (V + 1 posições) e o maior
+// grau orientado, que dimensiona a arena.
+int64_t* calcular_unidades(GrafoCSR* g, int k, int* maior_grau) {
+    int64_t* inicio_unidade = (int64_t*)malloc((g->V + 1) * sizeof(int64_t));
+    *maior_grau = 0;
+    inicio_unidade[0] = 0;
+    for (int v = 0; v < g->V; v++) {
+        int n;
+        candidatos_apos(g, v, &n);
+        *maior_grau = n > *maior_grau ? n : *maior_grau;
+        inicio_unidade[v + 1] = inicio_unidade[v] + (k > 2 && n > LIMIAR_DIVISAO ? n : 1);
+    }
+    return inicio_unidade;
+}
+
+// Contagem com memória de busca limitada a "orcamento" bytes (o grafo não
+// entra na conta). Se o pior caso de todas as threads não couber, usa menos
+// threads; se não couber nem uma, desiste.
+contagem_t contagem_de_cliques_limitada(GrafoPreparado* p, int k, size_t orcamento, ContadoresHW* perfil) {
+    int V = p->V;
+    int maior_grau;
+    int64_t* inicio_unidade = calcular_unidades(p->replicas[0], k, &maior_grau);
+
+    // A raiz usa a lista do CSR; os níveis 2 .. k-2 ocupam a arena (o último
+    // só conta) e cada um cabe no anterior.
+    size_t capacidade_arena = k > 3 ? (size_t)(k - 3) * maior_grau : 0;
+    size_t por_thread = capacidade_arena * sizeof(int) + k * sizeof(QuadroIterador) + sizeof(DadosLimitados);
+    int t = p->t;
+    if (por_thread * t > orcamento) {
+        int cabem = (int)(orcamento / por_thread);
+        if (cabem < 1) {
+            fprintf(stderr, "Orçamento de memória insuficiente: %.2f MB por thread, orçamento %.2f MB\n",
+                    por_thread / 1048576.0, orcamento / 1048576.0);
+            free(inicio_unidade);
+            exit(EXIT_FAILURE);
+        }
+        fprintf(stderr, "Orçamento de %.2f MB comporta %d de %d threads\n", orcamento / 1048576.0, cabem, t);
+        t = cabem;
+    }
+    printf("Memória limitada: %.2f MB de busca por thread (maior grau orientado %d), %d threads, %lld unidades\n",
+           por_thread / 1048576.0, maior_grau, t, (long long)inicio_unidade[V]);
+
+    DadosLimitados dados[t];
+    ContadorThread contadores[t];
+    for (int i = 0; i < t; i++) {
+        contadores[i].valor = 0;
+        dados[i].g = p->replicas[p->nos[i] < p->num_replicas ? p->nos[i] : 0];
+        dados[i].k = k;
+        dados[i].cpu = p->cpus[i];
+        dados[i].contador = &contadores[i];
+        dados[i].inicio_unidade = inicio_unidade;
+        dados[i].capacidade_arena = capacidade_arena;
+        dados[i].arena = (int*)malloc((capacidade_arena > 0 ? capacidade_arena : 1) * sizeof(int));
+        dados[i].pico_quadros = 0;
+        dados[i].pico_arena = 0;
+        dados[i].quadros = 0;
+        dados[i].hw = perfil != NULL ? &perfil[i] : NULL;
+#ifdef INSTRUMENTAR
+        dados[i].instr = &instrumentacao[i];
+#endif
+    }
+    rodar_unidades(dados, t, 0, inicio_unidade[V]);
+    for (int i = t; i < p->t && perfil != NULL; i++) {
+        for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+            perfil[i].fd[e] = -1;
+        }
+    }
+
+    contagem_t total_contador = 0;
+    int pico_quadros = 0;
+    size_t pico_arena = 0;
+    quadros_expandidos = 0;
+    for (int i = 0; i < t; i++) {
+        total_contador += contadores[i].valor;
+        quadros_expandidos += dados[i].quadros;
+        if (perfil != NULL) {
+            perfil[i].quadros = dados[i].quadros;
+        }
+        pico_quadros = dados[i].pico_quadros > pico_quadros ? dados[i].pico_quadros : pico_quadros;
+        pico_arena = dados[i].pico_arena > pico_arena ? dados[i].pico_arena : pico_arena;
+        free(dados[i].arena);
+    }
+    printf("Fronteira máxima por thread: %d quadros, %.2f KB de candidatos (arena de %.2f KB)\n",
+           pico_quadros, pico_arena * sizeof(int) / 1024.0, capacidade_arena * sizeof(int) / 1024.0);
+    free(inicio_unidade);
+    return total_contador;
+}
+
+// Modo intercalado (--intercalado=W): cada thread avança W buscas
+// independentes (cada uma com a pilha de iteradores e a arena do modo
+// limitado) em rodízio, um filho por vez. Antes de passar à próxima busca,
+// pede ao processador a lista do candidato que a busca atual vai expandir em
+// seguida e a posição no CSR do candidato depois dele; quando o rodízio volta
+// a ela, as faltas de cache já foram atendidas enquanto as outras W - 1
+// buscas trabalhavam.
+typedef struct BuscaIntercalada {
+    QuadroIterador* pilha;
+    int topo;
+    int* arena;
+    size_t uso_arena;
+} BuscaIntercalada;
+
+// Vizinhos maiores ficam no fim da lista e a busca binária de
+// candidatos_apos começa no meio: são essas as linhas trazidas.
+static inline void antecipar_lista(GrafoCSR* g, int w) {
+    const int* lista = g->vizinhos + g->inicio[w];
+    int grau = g->grau[w];
+    __builtin_prefetch(lista + (grau >> 1));
+    __builtin_prefetch(lista + grau - 1);
+}
+
+static inline void antecipar_posicao(GrafoCSR* g, int w) {
+    __builtin_prefetch(&g->inicio[w]);
+    __builtin_prefetch(&g->grau[w]);
+}
+
+// Próxima unidade para uma busca da thread; pega outro bloco do contador
+// global quando o atual acaba. Devolve -1 quando não há mais unidades.
+static int64_t pegar_unidade(DadosLimitados* data, int64_t* de, int64_t* ate) {
+    if (*de >= *ate) {
+        int64_t total_unidades = data->ultima_unidade;
+        *de = __atomic_fetch_add(data->proxima_unidade, BLOCO_UNIDADES, __ATOMIC_RELAXED);
+        if (*de >= total_unidades) {
+            *de = *ate = total_unidades;
+            return -1;
+        }
+        *ate = *de + BLOCO_UNIDADES < total_unidades ? *de + BLOCO_UNIDADES : total_unidades;
+    }
+    return (*de)++;
+}
+
+void* contagem_intercalada_thread(void* arg) {
+    DadosLimitados* data = (DadosLimitados*)arg;
+    GrafoCSR* g = data->g;
+    int k = data->k;
+    int largura = data->largura;
+    contagem_t contador = 0;
+    long long quadros = 0;
+
+    fixar_thread(data->cpu);
+    if (data->hw != NULL) {
+        abrir_contadores_hw(data->hw, false);
+        ligar_contadores_hw(data->hw);
+    }
+#ifdef INSTRUMENTAR
+    instr_thread = data->instr;
+    double inicio_ocupado = agora();
+#endif
+
+    BuscaIntercalada buscas[largura];
+    QuadroIterador* pilhas = (QuadroIterador*)malloc((size_t)largura * k * sizeof(QuadroIterador));
+    for (int i = 0; i < largura; i++) {
+        buscas[i].pilha = pilhas + (size_t)i * k;
+        buscas[i].topo = -1;
+        buscas[i].arena = data->arena + (size_t)i * data->capacidade_arena;
+        buscas[i].uso_arena = 0;
+    }
+
+    int64_t de = 0, ate = 0;
+    int ativas = largura;
+    for (int i = 0; ativas > 0; i = i + 1 < largura ? i + 1 : 0) {
+        BuscaIntercalada* b = &buscas[i];
+
+        // Busca vazia: começa a próxima unidade (k <= 2 não precisa de pilha).
+        while (b->topo == -1) {
+            int64_t u = pegar_unidade(data, &de, &ate);
+            if (u < 0) {
+                b->topo = -2;
+                ativas--;
+                break;
+            }
+            int v = raiz_da_unidade(data->inicio_unidade, g->V, u);
+            if (k == 1) {
+                contador++;
+                continue;
+            }
+            int n;
+            const int* maiores = candidatos_apos(g, v, &n);
+            int64_t unidades = data->inicio_unidade[v + 1] - data->inicio_unidade[v];
+            int inicio = unidades > 1 ? (int)(u - data->inicio_unidade[v]) : 0;
+            int limite = unidades > 1 ? inicio + 1 : n;
+            if (k == 2) {
+                contador += limite - inicio;
+                continue;
+            }
+            quadros++;
+            INSTR(instr_thread->quadros[1]++);
+            INSTR(instr_thread->candidatos += n);
+            if (inicio >= limite) {
+                continue;
+            }
+            b->topo = 0;
+            b->pilha[0].candidatos = maiores;
+            b->pilha[0].n = n;
+            b->pilha[0].proximo = inicio;
+            b->pilha[0].limite = limite;
+            antecipar_lista(g, maiores[inicio]);
+        }
+        if (b->topo < 0) {
+            continue;
+        }
+
+        // Um passo: o próximo candidato do quadro do topo.
+        QuadroIterador* q = &b->pilha[b->topo];
+        int w = q->candidatos[q->proximo++];
+        const int* restantes = q->candidatos + q->proximo;
+        int num_restantes = q->n - q->proximo;
+        if (b->topo + 3 == k) {
+            contador += intersecao_maiores(g, w, restantes, num_restantes, NULL);
+        } else {
+            int* filhos = b->arena + b->uso_arena;
+            int m = intersecao_maiores(g, w, restantes, num_restantes, filhos);
+            if (m > 0) {
+                b->uso_arena += m;
+                b->topo++;
+                quadros++;
+                INSTR(instr_thread->quadros[b->topo + 1 < MAX_PROFUNDIDADE ? b->topo + 1 : MAX_PROFUNDIDADE - 1]++);
+                INSTR(instr_thread->candidatos += m);
+                q = &b->pilha[b->topo];
+                q->candidatos = filhos;
+                q->n = m;
+                q->proximo = 0;
+                q->limite = m;
+            }
+        }
+
+        // Desempilha os quadros esgotados e antecipa o que vem depois.
+        while (b->topo >= 0 && b->pilha[b->topo].proximo >= b->pilha[b->topo].limite) {
+            if (b->topo > 0) {
+                b->uso_arena -= b->pilha[b->topo].n;
+            }
+            b->topo--;
+        }
+        if (b->topo >= 0) {
+            q = &b->pilha[b->topo];
+            antecipar_lista(g, q->candidatos[q->proximo]);
+            if (q->proximo + 1 < q->limite) {
+                antecipar_posicao(g, q->candidatos[q->proximo + 1]);
+            }
+        }
+    }
+    free(pilhas);
+
+    INSTR(registrar_evento("ocupado", inicio_ocupado, agora()));
+    if (data->hw != NULL) {
+        desligar_contadores_hw(data->hw);
+    }
+    data->quadros += quadros;
+    data->contador->valor += contador;
+    return NULL;
+}
+
+// Contagem intercalada com "largura" buscas por thread. A arena de cada
+// thread é a do modo limitado vezes a largura.
+contagem_t contagem_de_cliques_intercalada(GrafoPreparado* p, int k, int largura, ContadoresHW* perfil) {
+    int t = p->t;
+    int maior_grau;
+    int64_t* inicio_unidade = calcular_unidades(p->replicas[0], k, &maior_grau);
+    size_t capacidade_arena = k > 3 ? (size_t)(k - 3) * maior_grau : 0;
+    printf("Busca intercalada: %d buscas por thread, %.2f MB de arena por thread, %d threads, %lld unidades\n",
+           largura, largura * capacidade_arena * sizeof(int) / 1048576.0, t, (long long)inicio_unidade[p->V]);
+
+    DadosLimitados dados[t];
+    ContadorThread contadores[t];
+    pthread_t threads[t];
+    int64_t proxima_unidade = 0;
+    for (int i = 0; i < t; i++) {
+        contadores[i].valor = 0;
+        dados[i].g = p->replicas[p->nos[i] < p->num_replicas ? p->nos[i] : 0];
+        dados[i].k = k;
+        dados[i].cpu = p->cpus[i];
+        dados[i].contador = &contadores[i];
+        dados[i].inicio_unidade = inicio_unidade;
+        dados[i].proxima_unidade = &proxima_unidade;
+        dados[i].ultima_unidade = inicio_unidade[p->V];
+        dados[i].capacidade_arena = capacidade_arena;
+        dados[i].largura = largura;
+        dados[i].arena = (int*)malloc((largura * capacidade_arena > 0 ? largura * capacidade_arena : 1) * sizeof(int));
+        dados[i].quadros = 0;
+        dados[i].hw = perfil != NULL ? &perfil[i] : NULL;
+#ifdef INSTRUMENTAR
+        dados[i].instr = &instrumentacao[i];
+#endif
+        pthread_create(&threads[i], NULL, contagem_intercalada_thread, &dados[i]);
+    }
+
+    contagem_t total_contador = 0;
+    quadros_expandidos = 0;
+    for (int i = 0; i < t; i++) {
+        pthread_join(threads[i], NULL);
+        total_contador += contadores[i].valor;
+        quadros_expandidos += dados[i].quadros;
+        if (perfil != NULL) {
+            perfil[i].quadros = dados[i].quadros;
+        }
+        free(dados[i].arena);
+    }
+    free(inicio_unidade);
+    return total_contador;
+}
+// Execução em pipeline (--pipeline): leitura, montagem do CSR e contagem
+// no mesmo conjunto de threads, sem fases estritas. Cada thread lê um trecho
+// do edgelist (mapeado em memória e cortado em limites de linha) e separa as
+// arestas, nos dois sentidos, em baldes por faixa de vértices. Depois de uma
+// barreira, as faixas são montadas (graus, cópia, ordenação e remoção de
+// repetições) da última para a primeira: a busca a partir de v só lê listas
+// de vértices >= v, então as raízes de uma faixa vão para o escalonador com
+// roubo assim que ela e todas as seguintes estão prontas. Uma thread sem
+// trabalho na própria pilha monta a próxima faixa antes de tentar roubar.
+#define FAIXAS_POR_THREAD 16
+
+typedef struct BaldeArestas {
+    int* pares;
+    int64_t n;
+    int64_t capacidade;
+} BaldeArestas;
+
+typedef struct Pipeline {
+    const char* mapa;
+    size_t tamanho;
+    int V;
+    int t;
+    int num_faixas;
+    int* inicio_faixa;
+    int* faixa_de;
+    BaldeArestas* baldes;
+    int64_t* base_faixa;
+    GrafoCSR* g;
+    int proxima_faixa;
+    bool* pronta;
+    int publicada;
+    pthread_mutex_t mutex;
+    pthread_barrier_t barreira;
+    double inicio;
+    double fim_leitura;
+    double primeira_publicacao;
+    double fim_montagem;
+} Pipeline;
+
+static inline void anexar_par(BaldeArestas* b, int u, int v) {
+    if (b->n == b->capacidade) {
+        b->capacidade = b->capacidade > 0 ? 2 * b->capacidade : 1024;
+        b->pares = (int*)realloc(b->pares, 2 * b->capacidade * sizeof(int));
+    }
+    b->pares[2 * b->n] = u;
+    b->pares[2 * b->n + 1] = v;
+    b->n++;
+}
+
+// Primeira posição >= "pos" que começa uma linha.
+static size_t inicio_de_linha(Pipeline* pl, size_t pos) {
+    if (pos == 0 || pos >= pl->tamanho) {
+        return pos < pl->tamanho ? pos : pl->tamanho;
+    }
+    while (pos < pl->tamanho && pl->mapa[pos - 1] != '\n') {
+        pos++;
+    }
+    return pos;
+}
+
+// Separa as arestas do trecho "i" do arquivo nos baldes da thread "i".
+// Linhas sem dois inteiros são ignoradas.
+static void ler_trecho(Pipeline* pl, int i) {
+    const char* p = pl->mapa + inicio_de_linha(pl, pl->tamanho * i / pl->t);
+    const char* fim = pl->mapa + inicio_de_linha(pl, pl->tamanho * (i + 1) / pl->t);
+    BaldeArestas* baldes = pl->baldes + (size_t)i * pl->num_faixas;
+    while (p < fim) {
+        long valores[2];
+        int lidos = 0;
+        while (p < fim && *p != '\n' && lidos < 2) {
+            if (*p == '-' || (*p >= '0' && *p <= '9')) {
+                bool negativo = *p == '-';
+                p += negativo;
+                long x = 0;
+                while (p < fim && *p >= '0' && *p <= '9' && x < (1L << 40)) {
+                    x = x * 10 + (*p++ - '0');
+                }
+                valores[lidos++] = negativo ? -x : x;
+            } else if (*p == ' ' || *p == '\t' || *p == '\r') {
+                p++;
+            } else {
+                break;
+            }
+        }
+        while (p < fim && *p != '\n') {
+            p++;
+        }
+        p++;
+        if (lidos < 2) {
+            continue;
+        }
+        long u = valores[0], v = valores[1];
+        if (u < 0 || u >= pl->V || v < 0 || v >= pl->V || u == v) {
+            continue;
+        }
+        anexar_par(&baldes[pl->faixa_de[u]], (int)u, (int)v);
+        anexar_par(&baldes[pl->faixa_de[v]], (int)v, (int)u);
+    }
+}
+
+// Fase de leitura de cada thread; na barreira, uma delas reserva o CSR com
+// a posição de cada faixa.
+void ler_trecho_pipeline(Pipeline* pl, int i) {
+    ler_trecho(pl, i);
+    if (pthread_barrier_wait(&pl->barreira) == PTHREAD_BARRIER_SERIAL_THREAD) {
+        int64_t total = 0;
+        for (int f = 0; f < pl->num_faixas; f++) {
+            pl->base_faixa[f] = total;
+            for (int j = 0; j < pl->t; j++) {
+                total += pl->baldes[(size_t)j * pl->num_faixas + f].n;
+            }
+        }
+        pl->g->vizinhos = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+        pl->fim_leitura = agora() - pl->inicio;
+    }
+    pthread_barrier_wait(&pl->barreira);
+}
+
+static void montar_faixa(Pipeline* pl, int f) {
+    GrafoCSR* g = pl->g;
+    int a = pl->inicio_faixa[f], b = pl->inicio_faixa[f + 1];
+    for (int v = a; v < b; v++) {
+        g->grau[v] = 0;
+    }
+    for (int j = 0; j < pl->t; j++) {
+        BaldeArestas* balde = &pl->baldes[(size_t)j * pl->num_faixas + f];
+        for (int64_t e = 0; e < balde->n; e++) {
+            g->grau[balde->pares[2 * e]]++;
+        }
+    }
+    int64_t posicao = pl->base_faixa[f];
+    for (int v = a; v < b; v++) {
+        g->inicio[v] = posicao;
+        posicao += g->grau[v];
+        g->grau[v] = 0;
+    }
+    if (b == pl->V) {
+        g->inicio[b] = posicao;
+    }
+    for (int j = 0; j < pl->t; j++) {
+        BaldeArestas* balde = &pl->baldes[(size_t)j * pl->num_faixas + f];
+        for (int64_t e = 0; e < balde->n; e++) {
+            int u = balde->pares[2 * e];
+            g->vizinhos[g->inicio[u] + g->grau[u]++] = balde->pares[2 * e + 1];
+        }
+        free(balde->pares);
+        balde->pares = NULL;
+    }
+    for (int v = a; v < b; v++) {
+        g->grau[v] = ordenar_sem_repeticoes(g->vizinhos + g->inicio[v], g->grau[v]);
+    }
+}
 
-bool conexao_completa(Grafo* g, int* clique, int tamanho, int vizinho);
+// Monta a próxima faixa (em ordem decrescente) e publica na pilha da thread
+// as raízes de todas as faixas cujo sufixo ficou pronto. Devolve false se não
+// havia faixa a montar.
+bool montar_proxima_faixa(ThreadData* data) {
+    Pipeline* pl = data->pipeline;
+    int f = __atomic_sub_fetch(&pl->proxima_faixa, 1, __ATOMIC_RELAXED);
+    if (f < 0) {
+        return false;
+    }
+    montar_faixa(pl, f);
 
-pthread_mutex_t mutex_roubo = PTHREAD_MUTEX_INITIALIZER;
+    Lista* raizes = NULL;
+    Lista* ultima = NULL;
+    pthread_mutex_lock(&pl->mutex);
+    pl->pronta[f] = true;
+    while (pl->publicada > 0 && pl->pronta[pl->publicada - 1]) {
+        pl->publicada--;
+        int a = pl->inicio_faixa[pl->publicada], b = pl->inicio_faixa[pl->publicada + 1];
+        for (int v = a; v < b; v++) {
+            int* clique_inicial = malloc(sizeof(int));
+            clique_inicial[0] = v;
+            Lista* nova_lista = malloc(sizeof(Lista));
+            nova_lista->vertices = clique_inicial;
+            nova_lista->tamanho = 1;
+            nova_lista->prox = NULL;
+            if (ultima == NULL) {
+                raizes = nova_lista;
+            } else {
+                ultima->prox = nova_lista;
+            }
+            ultima = nova_lista;
+        }
+        if (pl->primeira_publicacao == 0) {
+            pl->primeira_publicacao = agora() - pl->inicio;
+        }
+        if (pl->publicada == 0) {
+            pl->fim_montagem = agora() - pl->inicio;
+        }
+    }
+    pthread_mutex_unlock(&pl->mutex);
 
-Nodo* criar_nodo(int vertice) {
-    Nodo* novo_nodo = (Nodo*)malloc(sizeof(Nodo));
-    novo_nodo->vertice = vertice;
-    novo_nodo->prox = NULL;
-    return novo_nodo;
+    if (raizes != NULL) {
+        pthread_mutex_lock(data->mutex);
+        ultima->prox = *data->cliques;
+        *data->cliques = raizes;
+        pthread_mutex_unlock(data->mutex);
+    }
+    return true;
 }
 
-Grafo* criar_grafo(int V) {
-    Grafo* g = (Grafo*)malloc(sizeof(Grafo));
-    g->V = V;
-    g->adj = (Nodo**)malloc(V * sizeof(Nodo*));
-    for (int i = 0; i < V; i++) {
-        g->adj[i] = NULL;
+// Conta direto do edgelist em pipeline. As fases se sobrepõem; para que as
+// linhas de tempo signifiquem o mesmo que no modo normal, a linha do tempo é
+// cortada em trechos consecutivos: carga até o fim da leitura,
+// pré-processamento até o CSR completo e execução daí até o resultado (a
+// contagem feita antes disso fica nas fases anteriores). A soma é o tempo
+// até a resposta. As opções de NUMA e --perf não se aplicam.
+int contar_em_pipeline(const char* arquivo, int V, int k, int t, int maxv) {
+    Pipeline pl;
+    memset(&pl, 0, sizeof(pl));
+    pl.inicio = agora();
+    int fd = open(arquivo, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        printf("Erro ao abrir o arquivo!\n");
+        exit(EXIT_FAILURE);
     }
-    return g;
+    pl.tamanho = (size_t)info.st_size;
+    pl.mapa = pl.tamanho > 0 ? (const char*)mmap(NULL, pl.tamanho, PROT_READ, MAP_PRIVATE, fd, 0) : "";
+    if (pl.mapa == MAP_FAILED) {
+        printf("Erro ao mapear o arquivo!\n");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    madvise((void*)pl.mapa, pl.tamanho, MADV_SEQUENTIAL);
+
+    pl.V = V;
+    pl.t = t;
+    pl.num_faixas = V < FAIXAS_POR_THREAD * t ? (V > 0 ? V : 1) : FAIXAS_POR_THREAD * t;
+    pl.inicio_faixa = (int*)malloc((pl.num_faixas + 1) * sizeof(int));
+    pl.faixa_de = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    for (int f = 0; f <= pl.num_faixas; f++) {
+        pl.inicio_faixa[f] = (int)((int64_t)V * f / pl.num_faixas);
+    }
+    for (int f = 0; f < pl.num_faixas; f++) {
+        for (int v = pl.inicio_faixa[f]; v < pl.inicio_faixa[f + 1]; v++) {
+            pl.faixa_de[v] = f;
+        }
+    }
+    pl.baldes = (BaldeArestas*)calloc((size_t)t * pl.num_faixas, sizeof(BaldeArestas));
+    pl.base_faixa = (int64_t*)malloc(pl.num_faixas * sizeof(int64_t));
+    pl.pronta = (bool*)calloc(pl.num_faixas, sizeof(bool));
+    pl.proxima_faixa = pl.num_faixas;
+    pl.publicada = pl.num_faixas;
+    pl.g = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+    pl.g->V = V;
+    pl.g->inicio = (int64_t*)malloc((V + 1) * sizeof(int64_t));
+    pl.g->inicio[V] = 0;
+    pl.g->grau = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    pl.g->vizinhos = NULL;
+    pthread_mutex_init(&pl.mutex, NULL);
+    pthread_barrier_init(&pl.barreira, NULL, t);
+
+#ifdef INSTRUMENTAR
+    iniciar_instrumentacao(t, false);
+#endif
+    pthread_t threads[t];
+    ThreadData dados[t];
+    ContadorThread contadores[t];
+    pthread_mutex_t mutexes[t];
+    Lista* trabalho_por_thread[t];
+    int ativos = t;
+    for (int i = 0; i < t; i++) {
+        contadores[i].valor = 0;
+        trabalho_por_thread[i] = NULL;
+        pthread_mutex_init(&mutexes[i], NULL);
+        dados[i].g = pl.g;
+        dados[i].k = k;
+        dados[i].contador = &contadores[i];
+        dados[i].cliques = &trabalho_por_thread[i];
+        dados[i].mutex = &mutexes[i];
+        dados[i].thread_id = i;
+        dados[i].num_threads = t;
+        dados[i].no = 0;
+        dados[i].cpu = -1;
+        dados[i].maxv = maxv > 0 ? maxv : 1;
+        dados[i].todas = dados;
+        dados[i].ativos = &ativos;
+        dados[i].quadros = 0;
+        dados[i].hw = NULL;
+        dados[i].pipeline = &pl;
+#ifdef INSTRUMENTAR
+        dados[i].instr = &instrumentacao[i];
+#endif
+    }
+    for (int i = 0; i < t; i++) {
+        pthread_create(&threads[i], NULL, contagem_de_cliques_thread, &dados[i]);
+    }
+    contagem_t resultado = 0;
+    for (int i = 0; i < t; i++) {
+        pthread_join(threads[i], NULL);
+        resultado += contadores[i].valor;
+        quadros_expandidos += dados[i].quadros;
+        pthread_mutex_destroy(&mutexes[i]);
+    }
+    double total = agora() - pl.inicio;
+
+    printf("Pipeline: %d faixas, leitura em %.6f s, primeira faixa publicada em %.6f s, "
+           "montagem concluída em %.6f s\n",
+           pl.num_faixas, pl.fim_leitura, pl.primeira_publicacao, pl.fim_montagem);
+    printf("Tempo de carga: %.6f segundos\n", pl.fim_leitura);
+    printf("Tempo de pré-processamento: %.6f segundos\n", pl.fim_montagem - pl.fim_leitura);
+    printf("Tempo de execução: %.6f segundos\n", total - pl.fim_montagem);
+    char texto_contagem[48];
+    printf("Número de cliques de tamanho %d: %s\n", k, formatar_contagem(resultado, texto_contagem));
+    printf("Tempo até a resposta: %.6f segundos\n", total);
+    INSTR(relatar_instrumentacao(t, NULL));
+    long residente = memoria_residente_maxima();
+    if (residente >= 0) {
+        printf("Memória residente máxima: %.2f MB\n", residente / 1024.0);
+    }
+
+    pthread_barrier_destroy(&pl.barreira);
+    pthread_mutex_destroy(&pl.mutex);
+    if (pl.tamanho > 0) {
+        munmap((void*)pl.mapa, pl.tamanho);
+    }
+    liberar_grafo_csr(pl.g);
+    free(pl.inicio_faixa);
+    free(pl.faixa_de);
+    free(pl.baldes);
+    free(pl.base_faixa);
+    free(pl.pronta);
+    return 0;
 }
 
-void adicionar_aresta(Grafo* g, int u, int v) {
-    Nodo* novo_nodo_v = criar_nodo(v);
-    novo_nodo_v->prox = g->adj[u];
-    g->adj[u] = novo_nodo_v;
+// Modo semi-externo (--externo=MB): as arestas ficam em disco e só os
+// vetores por vértice (graus e posições no arquivo) ficam em memória. O
+// grafo orientado (u -> v com u < v) é gravado num arquivo temporário em
+// --dir-externo (padrão $TMPDIR ou /tmp), listas ordenadas e sem repetições, sem nunca ter todas as arestas em
+// memória: o edgelist é distribuído em partes por faixa de vértices e cada
+// parte é ordenada sozinha. Na contagem, os blocos de raízes consecutivas
+// são dimensionados pelo orçamento: cada bloco traz as listas das raízes e
+// as de todos os vizinhos que elas tocam (as únicas consultadas pela busca
+// a partir delas). Uma thread de leitura monta o próximo bloco enquanto o
+// atual é contado, então o orçamento é dividido entre dois blocos.
+#define MAX_PARTES 512
+#define LEITURA_ADIANTE (1 << 18)
+// Listas tocadas separadas por menos que isso (em ints) no arquivo são lidas
+// numa só chamada, se couberem.
+#define LACUNA_LEITURA 1024
 
-    Nodo* novo_nodo_u = criar_nodo(u);
-    novo_nodo_u->prox = g->adj[v];
-    g->adj[v] = novo_nodo_u;
+typedef struct BlocoExterno {
+    GrafoCSR csr;
+    size_t capacidade;
+    int raiz_inicial;
+    int raiz_final;
+    int* tocados;
+    int num_tocados;
+    int capacidade_tocados;
+    bool pronto;
+} BlocoExterno;
+
+typedef struct GrafoExterno {
+    int V;
+    int fd;
+    char arquivo[256];
+    int64_t* inicio;
+    int maior_grau;
+    size_t limite_bloco;
+    BlocoExterno blocos[2];
+    int* marca;
+    int geracao;
+    bool fim;
+    pthread_mutex_t mutex;
+    pthread_cond_t mudou;
+    uint64_t bytes_lidos;
+    uint64_t bytes_preparo;
+    double tempo_leitura;
+    double tempo_espera;
+    int num_blocos;
+    size_t maior_bloco;
+} GrafoExterno;
+
+static inline int grau_externo(GrafoExterno* ge, int v) {
+    return (int)(ge->inicio[v + 1] - ge->inicio[v]);
 }
 
-Lista* roubar_trabalho(ThreadData* dados, int maxv) {
-    pthread_mutex_lock(&mutex_roubo);
-    Lista* item = dados->fila_trabalhos;
-    if (item) {
-        dados->fila_trabalhos = item->prox;
+// Lê "n" ints a partir da posição "de" (em ints) do arquivo de adjacência.
+void ler_faixa(GrafoExterno* ge, int* destino, int64_t de, int64_t n) {
+    double inicio = agora();
+    char* p = (char*)destino;
+    size_t falta = (size_t)n * sizeof(int);
+    off_t posicao = (off_t)de * sizeof(int);
+    while (falta > 0) {
+        ssize_t lidos = pread(ge->fd, p, falta, posicao);
+        if (lidos <= 0) {
+            fprintf(stderr, "Erro ao ler %s: %s\n", ge->arquivo, lidos < 0 ? strerror(errno) : "fim do arquivo");
+            exit(EXIT_FAILURE);
+        }
+        p += lidos;
+        posicao += lidos;
+        falta -= lidos;
     }
-    pthread_mutex_unlock(&mutex_roubo);
-    return item;
+    ge->bytes_lidos += (uint64_t)n * sizeof(int);
+    ge->tempo_leitura += agora() - inicio;
 }
 
+// Cria um arquivo temporário exclusivo em "diretorio" (o nome fica em
+// "nome", para mensagens) e já o remove do diretório: o descritor continua
+// válido, execuções simultâneas não se enxergam e nenhuma saída por erro
+// deixa arquivos para trás.
+int criar_temporario(const char* diretorio, char* nome, size_t tamanho) {
+    snprintf(nome, tamanho, "%s/kclique-externo-XXXXXX", diretorio);
+    int fd = mkstemp(nome);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao criar %s: %s\n", nome, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    unlink(nome);
+    return fd;
+}
 
-void* contagem_de_cliques_thread(void* arg) {
-    ThreadData* data = (ThreadData*)arg;
-    Grafo* g = data->g;
-    int k = data->k;
-    int* contador = data->contador;
-    Lista** cliques = data->cliques;
-    pthread_mutex_t* mutex = data->mutex;
+// Primeira passada: arestas (ainda com repetições) por vértice de origem.
+int64_t* contar_graus_brutos(const char* nome_arquivo, int V) {
+    FILE* arquivo = fopen(nome_arquivo, "r");
+    if (arquivo == NULL) {
+        printf("Erro ao abrir o arquivo!\n");
+        exit(EXIT_FAILURE);
+    }
+    int64_t* grau = (int64_t*)calloc(V, sizeof(int64_t));
+    int u, v;
+    while (fscanf(arquivo, "%d %d", &u, &v) == 2) {
+        if (u < 0 || u >= V || v < 0 || v >= V || u == v) {
+            continue;
+        }
+        grau[u < v ? u : v]++;
+    }
+    fclose(arquivo);
+    return grau;
+}
 
-    while (true) {
-        if (*cliques == NULL) {
-            *cliques = roubar_trabalho(data, 5); // Tenta roubar 5 itens de outra thread
-            if (*cliques == NULL) {
-                break;
+// Grava o grafo orientado em disco. Cada parte cabe no orçamento na hora de
+// ordenar (8 bytes por par lido mais 4 por vizinho ordenado).
+GrafoExterno* construir_grafo_externo(const char* nome_arquivo, const char* diretorio, int V,
+                                      int64_t* grau_bruto, size_t orcamento) {
+    int64_t por_parte = (int64_t)(orcamento / 12);
+    if (por_parte < 1) {
+        por_parte = 1;
+    }
+    int* parte_de = (int*)malloc(V * sizeof(int));
+    int inicio_parte[MAX_PARTES + 1];
+    int num_partes = 0;
+    int64_t acumulado = 0;
+    for (int v = 0; v < V; v++) {
+        if (num_partes == 0 || (acumulado + grau_bruto[v] > por_parte && acumulado > 0)) {
+            if (num_partes == MAX_PARTES) {
+                fprintf(stderr, "Orçamento pequeno demais: mais de %d partes\n", MAX_PARTES);
+                exit(EXIT_FAILURE);
             }
+            inicio_parte[num_partes++] = v;
+            acumulado = 0;
         }
+        acumulado += grau_bruto[v];
+        parte_de[v] = num_partes - 1;
+    }
+    inicio_parte[num_partes] = V;
 
-        Lista* clique_atual = *cliques;
-        *cliques = (*cliques)->prox;
-
-        if (clique_atual->tamanho == k) {
-            (*contador)++;
-            free(clique_atual->vertices);
-            free(clique_atual);
+    GrafoExterno* ge = (GrafoExterno*)calloc(1, sizeof(GrafoExterno));
+    ge->V = V;
+    char nome_parte[256];
+    FILE* partes[MAX_PARTES];
+    for (int p = 0; p < num_partes; p++) {
+        partes[p] = fdopen(criar_temporario(diretorio, nome_parte, sizeof(nome_parte)), "w+b");
+        if (partes[p] == NULL) {
+            fprintf(stderr, "Erro ao criar %s: %s\n", nome_parte, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+    FILE* arquivo = fopen(nome_arquivo, "r");
+    int u, v;
+    while (fscanf(arquivo, "%d %d", &u, &v) == 2) {
+        if (u < 0 || u >= V || v < 0 || v >= V || u == v) {
             continue;
         }
+        int par[2] = {u < v ? u : v, u < v ? v : u};
+        fwrite(par, sizeof(int), 2, partes[parte_de[par[0]]]);
+        ge->bytes_preparo += sizeof(par);
+    }
+    fclose(arquivo);
+    free(parte_de);
 
-        int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
-
-        for (int vizinho = ultimo_vertice + 1; vizinho < g->V; vizinho++) {
-            if (conexao_completa(g, clique_atual->vertices, clique_atual->tamanho, vizinho)) {
-                int* nova_clique = malloc((clique_atual->tamanho + 1) * sizeof(int));
-                memcpy(nova_clique, clique_atual->vertices, clique_atual->tamanho * sizeof(int));
-                nova_clique[clique_atual->tamanho] = vizinho;
+    ge->fd = criar_temporario(diretorio, ge->arquivo, sizeof(ge->arquivo));
+    FILE* saida = fdopen(dup(ge->fd), "wb");
+    if (saida == NULL) {
+        fprintf(stderr, "Erro ao criar %s: %s\n", ge->arquivo, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    ge->inicio = (int64_t*)malloc((V + 1) * sizeof(int64_t));
+    ge->inicio[0] = 0;
+    for (int p = 0; p < num_partes; p++) {
+        int de = inicio_parte[p], ate = inicio_parte[p + 1];
+        int64_t n = 0;
+        for (int x = de; x < ate; x++) {
+            n += grau_bruto[x];
+        }
+        int* pares = (int*)malloc((n > 0 ? n : 1) * 2 * sizeof(int));
+        int* vizinhos = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+        int64_t* posicao = (int64_t*)malloc((ate - de + 1) * sizeof(int64_t));
+        rewind(partes[p]);
+        if (fread(pares, 2 * sizeof(int), n, partes[p]) != (size_t)n) {
+            fprintf(stderr, "Erro ao ler a parte %d\n", p);
+            exit(EXIT_FAILURE);
+        }
+        ge->bytes_preparo += n * 2 * sizeof(int);
+        fclose(partes[p]);
 
-                Lista* nova_lista = malloc(sizeof(Lista));
-                nova_lista->vertices = nova_clique;
-                nova_lista->tamanho = clique_atual->tamanho + 1;
-                nova_lista->prox = *cliques;
-                *cliques = nova_lista;
+        posicao[0] = 0;
+        for (int x = de; x < ate; x++) {
+            posicao[x - de + 1] = posicao[x - de] + grau_bruto[x];
+        }
+        for (int64_t i = 0; i < n; i++) {
+            vizinhos[posicao[pares[2 * i] - de]++] = pares[2 * i + 1];
+        }
+        int64_t comeco = 0;
+        for (int x = de; x < ate; x++) {
+            int* lista = vizinhos + comeco;
+            int tamanho = (int)grau_bruto[x];
+            qsort(lista, tamanho, sizeof(int), comparar_int);
+            int unicos = 0;
+            for (int i = 0; i < tamanho; i++) {
+                if (unicos == 0 || lista[unicos - 1] != lista[i]) {
+                    lista[unicos++] = lista[i];
+                }
             }
+            fwrite(lista, sizeof(int), unicos, saida);
+            ge->bytes_preparo += unicos * sizeof(int);
+            ge->inicio[x + 1] = ge->inicio[x] + unicos;
+            ge->maior_grau = unicos > ge->maior_grau ? unicos : ge->maior_grau;
+            comeco += tamanho;
         }
+        free(pares);
+        free(vizinhos);
+        free(posicao);
+    }
+    if (fclose(saida) != 0) {
+        fprintf(stderr, "Erro ao gravar %s: %s\n", ge->arquivo, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
 
-        free(clique_atual->vertices);
-        free(clique_atual);
+    ge->limite_bloco = orcamento / 2 / sizeof(int);
+    if (ge->limite_bloco < 1) {
+        ge->limite_bloco = 1;
     }
-    return NULL;
+    for (int b = 0; b < 2; b++) {
+        BlocoExterno* bloco = &ge->blocos[b];
+        bloco->csr.V = V;
+        bloco->csr.inicio = (int64_t*)calloc(V, sizeof(int64_t));
+        bloco->csr.grau = (int*)calloc(V, sizeof(int));
+        bloco->capacidade = ge->limite_bloco;
+        bloco->csr.vizinhos = (int*)malloc(bloco->capacidade * sizeof(int));
+        bloco->capacidade_tocados = 1024;
+        bloco->tocados = (int*)malloc(bloco->capacidade_tocados * sizeof(int));
+    }
+    ge->marca = (int*)calloc(V, sizeof(int));
+    pthread_mutex_init(&ge->mutex, NULL);
+    pthread_cond_init(&ge->mudou, NULL);
+    printf("Grafo externo: %lld arestas orientadas em %s (%d partes), blocos de até %.2f MB\n",
+           (long long)ge->inicio[V], ge->arquivo, num_partes, ge->limite_bloco * sizeof(int) / 1048576.0);
+    return ge;
 }
 
-int contagem_de_cliques_paralela(Grafo* g, int k, int t, int maxv) {
-    Lista* cliques = NULL;
-    pthread_t threads[t];
-    ThreadData dados[t];
-    int contadores[t];
-    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
-    Lista* trabalho_por_thread[t];
+void liberar_grafo_externo(GrafoExterno* ge) {
+    close(ge->fd);
+    for (int b = 0; b < 2; b++) {
+        free(ge->blocos[b].csr.inicio);
+        free(ge->blocos[b].csr.grau);
+        free(ge->blocos[b].csr.vizinhos);
+        free(ge->blocos[b].tocados);
+    }
+    pthread_mutex_destroy(&ge->mutex);
+    pthread_cond_destroy(&ge->mudou);
+    free(ge->marca);
+    free(ge->inicio);
+    free(ge);
+}
 
-    for (int i = 0; i < t; i++) {
-        contadores[i] = 0;
-        trabalho_por_thread[i] = NULL;
+static void garantir_capacidade(BlocoExterno* b, size_t ints) {
+    if (ints > b->capacidade) {
+        b->capacidade = ints;
+        b->csr.vizinhos = (int*)realloc(b->csr.vizinhos, b->capacidade * sizeof(int));
     }
+}
 
-    for (int v = 0; v < g->V; v++) {
-        int* clique_inicial = malloc(sizeof(int));
-        clique_inicial[0] = v;
-        Lista* nova_lista = malloc(sizeof(Lista));
-        nova_lista->vertices = clique_inicial;
-        nova_lista->tamanho = 1;
-        nova_lista->prox = cliques;
-        cliques = nova_lista;
+// Monta em "b" o bloco que começa na raiz "a": as raízes entram enquanto a
+// soma dos graus de tudo o que tocam couber no limite (a primeira sempre
+// entra, aumentando o bloco se preciso). As listas das raízes são lidas em
+// sequência; as dos outros vértices tocados, em ordem de posição no arquivo.
+void montar_bloco(GrafoExterno* ge, BlocoExterno* b, int a) {
+    ge->geracao++;
+    int64_t base = ge->inicio[a];
+    int64_t fim_arquivo = ge->inicio[ge->V] - base;
+    int64_t lido = 0;
+    size_t pegada = 0;
+    b->num_tocados = 0;
+    int v = a;
+    while (v < ge->V) {
+        int64_t fim_lista = ge->inicio[v + 1] - base;
+        if (fim_lista > lido) {
+            if ((size_t)fim_lista > b->capacidade) {
+                if (v > a) {
+                    break;
+                }
+                garantir_capacidade(b, fim_lista);
+            }
+            int64_t quero = fim_lista - lido;
+            int64_t adiante = (int64_t)b->capacidade - lido;
+            adiante = adiante < LEITURA_ADIANTE ? adiante : LEITURA_ADIANTE;
+            adiante = adiante < fim_arquivo - lido ? adiante : fim_arquivo - lido;
+            int64_t n = quero > adiante ? quero : adiante;
+            ler_faixa(ge, b->csr.vizinhos + lido, base + lido, n);
+            lido += n;
+        }
+        const int* lista = b->csr.vizinhos + (ge->inicio[v] - base);
+        int grau = grau_externo(ge, v);
+        size_t custo = ge->marca[v] != ge->geracao ? grau : 0;
+        for (int i = 0; i < grau; i++) {
+            if (ge->marca[lista[i]] != ge->geracao) {
+                custo += grau_externo(ge, lista[i]);
+            }
+        }
+        if (v > a && pegada + custo > ge->limite_bloco) {
+            break;
+        }
+        if (v == a && custo > b->capacidade) {
+            fprintf(stderr, "Raiz %d toca %.2f MB, acima do bloco; bloco ampliado\n",
+                    v, custo * sizeof(int) / 1048576.0);
+        }
+        ge->marca[v] = ge->geracao;
+        for (int i = 0; i < grau; i++) {
+            int w = lista[i];
+            if (ge->marca[w] != ge->geracao) {
+                ge->marca[w] = ge->geracao;
+                if (b->num_tocados == b->capacidade_tocados) {
+                    b->capacidade_tocados *= 2;
+                    b->tocados = (int*)realloc(b->tocados, b->capacidade_tocados * sizeof(int));
+                }
+                b->tocados[b->num_tocados++] = w;
+            }
+        }
+        pegada += custo;
+        v++;
+    }
+    b->raiz_inicial = a;
+    b->raiz_final = v;
+    garantir_capacidade(b, pegada);
+
+    for (int r = a; r < v; r++) {
+        b->csr.inicio[r] = ge->inicio[r] - base;
+        b->csr.grau[r] = grau_externo(ge, r);
+    }
+
+    // Tocados que não são raízes do bloco, em ordem de posição no arquivo.
+    int n = 0;
+    size_t restante = 0;
+    for (int i = 0; i < b->num_tocados; i++) {
+        if (b->tocados[i] >= v) {
+            b->tocados[n++] = b->tocados[i];
+            restante += grau_externo(ge, b->tocados[i]);
+        }
     }
+    b->num_tocados = n;
+    qsort(b->tocados, n, sizeof(int), comparar_int);
+    int64_t posicao = ge->inicio[v] - base;
+    for (int i = 0; i < n;) {
+        int64_t de = ge->inicio[b->tocados[i]];
+        int64_t ate = ge->inicio[b->tocados[i] + 1];
+        size_t no_trecho = grau_externo(ge, b->tocados[i]);
+        int j = i + 1;
+        while (j < n) {
+            int w = b->tocados[j];
+            int64_t novo_ate = ge->inicio[w + 1];
+            size_t depois = restante - no_trecho - grau_externo(ge, w);
+            if (ge->inicio[w] - ate > LACUNA_LEITURA
+                || (size_t)(posicao + (novo_ate - de)) + depois > b->capacidade) {
+                break;
+            }
+            ate = novo_ate;
+            no_trecho += grau_externo(ge, w);
+            j++;
+        }
+        ler_faixa(ge, b->csr.vizinhos + posicao, de, ate - de);
+        for (int x = i; x < j; x++) {
+            int w = b->tocados[x];
+            b->csr.inicio[w] = posicao + (ge->inicio[w] - de);
+            b->csr.grau[w] = grau_externo(ge, w);
+        }
+        posicao += ate - de;
+        restante -= no_trecho;
+        i = j;
+    }
+    ge->num_blocos++;
+    if ((size_t)posicao > ge->maior_bloco) {
+        ge->maior_bloco = posicao;
+    }
+}
+
+// Thread de leitura: monta os blocos em ordem, alternando os dois buffers,
+// e espera o contador liberar um buffer antes de reutilizá-lo.
+void* ler_blocos(void* arg) {
+    GrafoExterno* ge = (GrafoExterno*)arg;
+    int proxima_raiz = 0;
+    for (int n = 0;; n++) {
+        BlocoExterno* b = &ge->blocos[n % 2];
+        pthread_mutex_lock(&ge->mutex);
+        while (b->pronto) {
+            pthread_cond_wait(&ge->mudou, &ge->mutex);
+        }
+        pthread_mutex_unlock(&ge->mutex);
+        if (proxima_raiz >= ge->V) {
+            pthread_mutex_lock(&ge->mutex);
+            ge->fim = true;
+            pthread_cond_broadcast(&ge->mudou);
+            pthread_mutex_unlock(&ge->mutex);
+            return NULL;
+        }
+        montar_bloco(ge, b, proxima_raiz);
+        proxima_raiz = b->raiz_final;
+        pthread_mutex_lock(&ge->mutex);
+        b->pronto = true;
+        pthread_cond_broadcast(&ge->mudou);
+        pthread_mutex_unlock(&ge->mutex);
+    }
+}
 
-    Lista* atual = cliques;
-    int indice = 0;
-    while (atual != NULL) {
-        Lista* proximo = atual->prox;
-        atual->prox = trabalho_por_thread[indice];
-        trabalho_por_thread[indice] = atual;
-        indice = (indice + 1) % t;
-        atual = proximo;
+// Conta bloco a bloco com as threads do modo limitado; cada bloco usa as
+// unidades das próprias raízes.
+contagem_t contagem_de_cliques_externa(GrafoExterno* ge, int k, int t) {
+    int V = ge->V;
+    int64_t* inicio_unidade = (int64_t*)malloc((V + 1) * sizeof(int64_t));
+    inicio_unidade[0] = 0;
+    for (int v = 0; v < V; v++) {
+        int n = grau_externo(ge, v);
+        inicio_unidade[v + 1] = inicio_unidade[v] + (k > 2 && n > LIMIAR_DIVISAO ? n : 1);
     }
+    size_t capacidade_arena = k > 3 ? (size_t)(k - 3) * ge->maior_grau : 0;
 
+    DadosLimitados dados[t];
+    ContadorThread contadores[t];
     for (int i = 0; i < t; i++) {
-        dados[i].g = g;
+        contadores[i].valor = 0;
         dados[i].k = k;
+        dados[i].cpu = -1;
         dados[i].contador = &contadores[i];
-        dados[i].cliques = &trabalho_por_thread[i];
-        dados[i].mutex = &mutex;
-        dados[i].trabalhos_geral = &trabalho_por_thread[i];
-        dados[i].fila_trabalhos = NULL;  // Fila inicial para cada thread
-        dados[i].thread_id = i;
-        dados[i].ativo = true;
-
-        pthread_create(&threads[i], NULL, contagem_de_cliques_thread, &dados[i]);
+        dados[i].inicio_unidade = inicio_unidade;
+        dados[i].capacidade_arena = capacidade_arena;
+        dados[i].arena = (int*)malloc((capacidade_arena > 0 ? capacidade_arena : 1) * sizeof(int));
+        dados[i].pico_quadros = 0;
+        dados[i].pico_arena = 0;
+        dados[i].quadros = 0;
+        dados[i].hw = NULL;
+#ifdef INSTRUMENTAR
+        dados[i].instr = &instrumentacao[i];
+#endif
     }
 
-    for (int i = 0; i < t; i++) {
-        pthread_join(threads[i], NULL);
+    pthread_t leitor;
+    pthread_create(&leitor, NULL, ler_blocos, ge);
+    for (int n = 0;; n++) {
+        BlocoExterno* b = &ge->blocos[n % 2];
+        double inicio_espera = agora();
+        pthread_mutex_lock(&ge->mutex);
+        while (!b->pronto && !ge->fim) {
+            pthread_cond_wait(&ge->mudou, &ge->mutex);
+        }
+        bool tem_bloco = b->pronto;
+        pthread_mutex_unlock(&ge->mutex);
+        ge->tempo_espera += agora() - inicio_espera;
+        if (!tem_bloco) {
+            break;
+        }
+
+        for (int i = 0; i < t; i++) {
+            dados[i].g = &b->csr;
+        }
+        rodar_unidades(dados, t, inicio_unidade[b->raiz_inicial], inicio_unidade[b->raiz_final]);
+
+        for (int r = b->raiz_inicial; r < b->raiz_final; r++) {
+            b->csr.grau[r] = 0;
+        }
+        for (int i = 0; i < b->num_tocados; i++) {
+            b->csr.grau[b->tocados[i]] = 0;
+        }
+        pthread_mutex_lock(&ge->mutex);
+        b->pronto = false;
+        pthread_cond_broadcast(&ge->mudou);
+        pthread_mutex_unlock(&ge->mutex);
     }
+    pthread_join(leitor, NULL);
 
-    int total_contador = 0;
+    contagem_t total_contador = 0;
+    quadros_expandidos = 0;
     for (int i = 0; i < t; i++) {
-        total_contador += contadores[i];
+        total_contador += contadores[i].valor;
+        quadros_expandidos += dados[i].quadros;
+        free(dados[i].arena);
     }
-
+    free(inicio_unidade);
     return total_contador;
 }
 
+// Fluxo completo do modo externo, com as mesmas linhas de tempo do normal.
+int contar_externo(const char* arquivo, const char* diretorio, int V, int k, int t, size_t orcamento) {
+    struct timespec start_time, end_time;
+    double inicio_total = agora();
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    int64_t* grau_bruto = contar_graus_brutos(arquivo, V);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    printf("Tempo de carga: %.6f segundos\n",
+           (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    GrafoExterno* ge = construir_grafo_externo(arquivo, diretorio, V, grau_bruto, orcamento);
+    free(grau_bruto);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    printf("Tempo de pré-processamento: %.6f segundos\n",
+           (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+
+#ifdef INSTRUMENTAR
+    iniciar_instrumentacao(t, false);
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    contagem_t resultado = contagem_de_cliques_externa(ge, k, t);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    printf("Tempo de execução: %.6f segundos\n",
+           (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+    char texto_contagem[48];
+    printf("Número de cliques de tamanho %d: %s\n", k, formatar_contagem(resultado, texto_contagem));
+    printf("Tempo até a resposta: %.6f segundos\n", agora() - inicio_total);
+    printf("E/S: preparo %.2f MB; contagem %d blocos (maior %.2f MB), %.2f MB lidos em %.6f s, "
+           "espera por E/S %.6f s\n",
+           ge->bytes_preparo / 1048576.0, ge->num_blocos, ge->maior_bloco * sizeof(int) / 1048576.0,
+           ge->bytes_lidos / 1048576.0, ge->tempo_leitura, ge->tempo_espera);
+    INSTR(relatar_instrumentacao(t, NULL));
+    long residente = memoria_residente_maxima();
+    if (residente >= 0) {
+        printf("Memória residente máxima: %.2f MB\n", residente / 1024.0);
+    }
+    liberar_grafo_externo(ge);
+    return 0;
+}
 
-bool conexao_completa(Grafo* g, int* clique, int tamanho, int vizinho) {
+bool conexao_completa(GrafoCSR* g, int* clique, int tamanho, int vizinho) {
     for (int i = 0; i < tamanho; i++) {
+        INSTR(instr_thread->sondagens++);
         int vertice = clique[i];
-        Nodo* adj = g->adj[vertice];
+        int64_t lo = g->inicio[vertice], hi = g->inicio[vertice] + g->grau[vertice] - 1;
         bool conectado = false;
 
-        while (adj != NULL) {
-            if (adj->vertice == vizinho) {
+        while (lo <= hi) {
+            int64_t meio = (lo + hi) >> 1;
+            if (g->vizinhos[meio] == vizinho) {
                 conectado = true;
                 break;
             }
-            adj = adj->prox;
+            if (g->vizinhos[meio] < vizinho) {
+                lo = meio + 1;
+            } else {
+                hi = meio - 1;
+            }
         }
 
         if (!conectado) {
@@ -235,15 +2369,54 @@ void liberar_grafo(Grafo* g) {
 }
 
 
+// Procura "--nome=valor" nos argumentos opcionais.
+const char* obter_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+    size_t n = strlen(nome);
+    for (int i = primeiro; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, nome, n) == 0
+            && argv[i][n + 2] == '=') {
+            return argv[i] + n + 3;
+        }
+    }
+    return NULL;
+}
+
+bool tem_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+    for (int i = primeiro; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strcmp(argv[i] + 2, nome) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Datasets fora da lista (por exemplo, gerados pelo gerador.c): o número de
+// vértices é o maior ID em <dataset>.edgelist mais um.
+int vertices_do_arquivo(const char* dataset) {
+    char arquivo[110];
+    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+    FILE* f = fopen(arquivo, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    int u, v, maior = -1;
+    while (fscanf(f, "%d %d", &u, &v) == 2) {
+        maior = u > maior ? u : maior;
+        maior = v > maior ? v : maior;
+    }
+    fclose(f);
+    return maior + 1;
+}
+
 int main(int argc, char *argv[]) {
-    if (argc != 5) {
-        fprintf(stderr, "Usage: %s <dataset> <k> <num_threads> <maxv_roubado>\n", argv[0]);
+    if (argc < 5) {
+        fprintf(stderr, "Usage: %s <dataset> <k> <num_threads> <maxv_roubado> [--afinidade=compacta|espalhada] [--replicar] [--paginas-grandes] [--trace=arquivo.json] [--perf] [--memoria=MB] [--intercalado=W] [--externo=MB [--dir-externo=DIR]] [--pipeline]\n", argv[0]);
         return 1;
     }
 
-    char dataset[30];
+    char dataset[100];
     int k, num_threads, maxv_roubado;
-    strcpy(dataset, argv[1]);
+    snprintf(dataset, sizeof(dataset), "%s", argv[1]);
     k = atoi(argv[2]);
     num_threads = atoi(argv[3]);
     maxv_roubado = atoi(argv[4]);
@@ -257,27 +2430,179 @@ int main(int argc, char *argv[]) {
     } else if (strcmp(dataset, "dblp") == 0) {
         num_vertices = 317080;
     } else {
+        num_vertices = vertices_do_arquivo(dataset);
+        if (num_vertices <= 0) {
+            fprintf(stderr, "Dataset desconhecido: %s\n", dataset);
+            return 1;
+        }
+    }
+
+    char arquivo[110];
+    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+
+    // --memoria=MB: busca preguiçosa com fronteira limitada (ver
+    // contagem_de_cliques_limitada); --intercalado=W: a mesma busca com W
+    // quadros por thread em rodízio (ver contagem_de_cliques_intercalada),
+    // que não respeita o limite de memória.
+    const char* memoria = obter_opcao(argc, argv, 5, "memoria");
+    const char* intercalado = obter_opcao(argc, argv, 5, "intercalado");
+    if (memoria != NULL && intercalado != NULL) {
+        fprintf(stderr, "--memoria e --intercalado não podem ser usados juntos\n");
+        return 1;
+    }
+
+    // --externo=MB: arestas em disco, contagem por blocos (ver
+    // contar_externo), com os temporários em --dir-externo; --pipeline: leitura, montagem do CSR e contagem
+    // sobrepostas (ver contar_em_pipeline). Os dois têm carga e busca
+    // próprias, sem as opções de busca, NUMA, --trace e --perf.
+    const char* externo = obter_opcao(argc, argv, 5, "externo");
+    bool pipeline = tem_opcao(argc, argv, 5, "pipeline");
+    if (externo != NULL && pipeline) {
+        fprintf(stderr, "--externo e --pipeline não podem ser usados juntos\n");
         return 1;
     }
+    if (externo != NULL || pipeline) {
+        const char* incompativeis[] = {"memoria", "intercalado", "trace", "afinidade",
+                                       "replicar", "paginas-grandes", "perf"};
+        for (size_t i = 0; i < sizeof(incompativeis) / sizeof(incompativeis[0]); i++) {
+            if (tem_opcao(argc, argv, 5, incompativeis[i])
+                || obter_opcao(argc, argv, 5, incompativeis[i]) != NULL) {
+                fprintf(stderr, "--%s não pode ser usado com %s\n", incompativeis[i],
+                        externo != NULL ? "--externo" : "--pipeline");
+                return 1;
+            }
+        }
+    }
+    if (externo != NULL) {
+        const char* diretorio = obter_opcao(argc, argv, 5, "dir-externo");
+        if (diretorio == NULL) {
+            diretorio = getenv("TMPDIR") != NULL ? getenv("TMPDIR") : "/tmp";
+        }
+        return contar_externo(arquivo, diretorio, num_vertices, k, num_threads,
+                              (size_t)(atof(externo) * 1048576.0));
+    }
+
+    if (pipeline) {
+        return contar_em_pipeline(arquivo, num_vertices, k, num_threads, maxv_roubado);
+    }
 
     Grafo* g = criar_grafo(num_vertices);
 
-    char arquivo[110];
-    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+    // --perf: contadores de hardware por fase e, na contagem, por thread.
+    ContadoresHW perfil_principal;
+    ContadoresHW* perfil = NULL;
+    if (tem_opcao(argc, argv, 5, "perf")) {
+        int abertos = abrir_contadores_hw(&perfil_principal, true);
+        if (abertos == 0) {
+            fprintf(stderr, "Contadores de hardware indisponíveis (%s); --perf ignorado\n",
+                    strerror(perfil_principal.erro));
+        } else {
+            if (abertos < NUM_EVENTOS_HW) {
+                fprintf(stderr, "Alguns contadores de hardware não estão disponíveis (%s)\n",
+                        strerror(perfil_principal.erro));
+            }
+            perfil = (ContadoresHW*)calloc(num_threads, sizeof(ContadoresHW));
+        }
+    }
 
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    double inicio_total = agora();
+    if (perfil != NULL) {
+        ligar_contadores_hw(&perfil_principal);
+    }
     carregar_grafo_de_arquivo(g, arquivo);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    printf("Tempo de carga: %.6f segundos\n",
+           (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+    if (perfil != NULL) {
+        desligar_contadores_hw(&perfil_principal);
+        imprimir_contadores_hw("Perfil HW (carga)", &perfil_principal, 0);
+    }
+
+    ConfigNuma config;
+    config.afinidade = obter_opcao(argc, argv, 5, "afinidade");
+    config.replicar = tem_opcao(argc, argv, 5, "replicar");
+    config.paginas_grandes = tem_opcao(argc, argv, 5, "paginas-grandes");
+    if (config.replicar && config.afinidade == NULL) {
+        config.afinidade = "compacta";
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    if (perfil != NULL) {
+        ligar_contadores_hw(&perfil_principal);
+    }
+    GrafoPreparado* preparado = preparar_grafo(g, num_threads, &config);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    printf("Tempo de pré-processamento: %.6f segundos\n",
+           (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+    if (perfil != NULL) {
+        desligar_contadores_hw(&perfil_principal);
+        imprimir_contadores_hw("Perfil HW (pré-processamento)", &perfil_principal, 0);
+        fechar_contadores_hw(&perfil_principal);
+    }
+
+    const char* trilha = obter_opcao(argc, argv, 5, "trace");
+#ifdef INSTRUMENTAR
+    iniciar_instrumentacao(num_threads, trilha != NULL);
+#else
+    if (trilha != NULL) {
+        fprintf(stderr, "--trace requer compilação com -DINSTRUMENTAR; ignorado\n");
+    }
+#endif
 
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-    int resultado = contagem_de_cliques_paralela(g, k, num_threads,maxv_roubado);
+    // Sem --memoria nem --intercalado, a pilha de quadros com roubo.
+    contagem_t resultado;
+    if (intercalado != NULL) {
+        int largura = atoi(intercalado);
+        resultado = contagem_de_cliques_intercalada(preparado, k, largura > 0 ? largura : 1, perfil);
+    } else if (memoria != NULL) {
+        resultado = contagem_de_cliques_limitada(preparado, k, (size_t)(atof(memoria) * 1048576.0), perfil);
+    } else {
+        resultado = contagem_de_cliques_paralela(preparado, k, maxv_roubado, perfil);
+    }
 
     clock_gettime(CLOCK_MONOTONIC, &end_time);
     
     double time_spent = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
 
     printf("Tempo de execução: %.6f segundos\n", time_spent);
-    printf("Número de cliques de tamanho %d: %d\n", k, resultado);
+    char texto_contagem[48];
+    printf("Número de cliques de tamanho %d: %s\n", k, formatar_contagem(resultado, texto_contagem));
+    printf("Tempo até a resposta: %.6f segundos\n", agora() - inicio_total);
+    long residente = memoria_residente_maxima();
+    if (residente >= 0) {
+        printf("Memória residente máxima: %.2f MB\n", residente / 1024.0);
+    }
+    INSTR(relatar_instrumentacao(num_threads, trilha));
+
+    if (perfil != NULL) {
+        ContadoresHW total;
+        memset(&total, 0, sizeof(total));
+        for (int e = 0; e < NUM_EVENTOS_HW; e++) {
+            total.fd[e] = -1;
+            for (int i = 0; i < num_threads; i++) {
+                if (perfil[i].fd[e] >= 0) {
+                    total.fd[e] = perfil[i].fd[e];
+                    total.valor[e] += perfil[i].valor[e];
+                }
+            }
+        }
+        imprimir_contadores_hw("Perfil HW (contagem)", &total, quadros_expandidos);
+        for (int i = 0; i < num_threads && num_threads > 1; i++) {
+            char rotulo[32];
+            snprintf(rotulo, sizeof(rotulo), "  Thread %d", i);
+            imprimir_contadores_hw(rotulo, &perfil[i], perfil[i].quadros);
+            fechar_contadores_hw(&perfil[i]);
+        }
+        if (num_threads == 1) {
+            fechar_contadores_hw(&perfil[0]);
+        }
+        free(perfil);
+    }
 
+    liberar_grafo_preparado(preparado);
     liberar_grafo(g);
 
     return 0;
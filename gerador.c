@@ -0,0 +1,380 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <omp.h>
+
+// Gerador de grafos sintéticos para testes de escalabilidade e de correção.
+// Modelos:
+//   er        Erdős–Rényi G(n, m): m pares uniformes (repetições descartadas)
+//   rmat      R-MAT/Kronecker: 2^escala vértices, fator * 2^escala arestas
+//   ba        Barabási–Albert: cada vértice novo liga-se a "grau" existentes
+//   plantada  "cliques" cliques disjuntas de "tamanho" vértices, ligadas ao
+//             resto por uma floresta aleatória (sem triângulos), com os IDs
+//             embaralhados; o número de k-cliques é conhecido
+//
+// A geração é dividida em NUM_BLOCOS blocos, cada um com o próprio gerador
+// pseudoaleatório derivado da semente, de modo que o grafo é o mesmo para
+// qualquer número de threads. O modelo ba é sequencial (cada vértice depende
+// dos graus anteriores).
+//
+// Saída: <saida>.edgelist (uma aresta "u v" por linha, u < v) e/ou
+// <saida>.bin no formato binário do t3-mpi ("KCLQBIN1", V, E e E pares de
+// int32). Para o modelo plantada, <saida>.cliques guarda "k contagem" para
+// k = 3..tamanho. Os executáveis aceitam <saida> como dataset.
+//
+// Compilação: gcc -O2 -fopenmp gerador.c -o gerador
+
+#define NUM_BLOCOS 256
+#define MAGICO_BINARIO "KCLQBIN1"
+
+typedef struct Aleatorio {
+    uint64_t estado;
+} Aleatorio;
+
+// splitmix64: rápido, com boa distribuição e estado de uma palavra.
+static inline uint64_t proximo(Aleatorio* a) {
+    uint64_t z = (a->estado += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline double uniforme(Aleatorio* a) {
+    return (proximo(a) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline int64_t sortear(Aleatorio* a, int64_t n) {
+    return (int64_t)(proximo(a) % (uint64_t)n);
+}
+
+Aleatorio aleatorio_do_bloco(uint64_t semente, int bloco) {
+    Aleatorio a = {semente * 0x2545F4914F6CDD1Dull + (uint64_t)bloco + 1};
+    proximo(&a);
+    return a;
+}
+
+// Arestas como chaves de 64 bits (menor << 32 | maior), para ordenar e
+// remover repetições de uma vez.
+typedef struct Arestas {
+    uint64_t* chaves;
+    int64_t n;
+} Arestas;
+
+static inline uint64_t chave(int u, int v) {
+    return u < v ? ((uint64_t)u << 32) | (uint32_t)v : ((uint64_t)v << 32) | (uint32_t)u;
+}
+
+int comparar_chave(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Descarta laços (marcados como UINT64_MAX) e repetições.
+void normalizar(Arestas* e) {
+    qsort(e->chaves, e->n, sizeof(uint64_t), comparar_chave);
+    int64_t m = 0;
+    for (int64_t i = 0; i < e->n; i++) {
+        if (e->chaves[i] == UINT64_MAX || (m > 0 && e->chaves[m - 1] == e->chaves[i])) {
+            continue;
+        }
+        e->chaves[m++] = e->chaves[i];
+    }
+    e->n = m;
+}
+
+static inline uint64_t chave_ou_laco(int u, int v) {
+    return u == v ? UINT64_MAX : chave(u, v);
+}
+
+Arestas gerar_er(int n, int64_t m, uint64_t semente) {
+    Arestas e = {(uint64_t*)malloc(m * sizeof(uint64_t)), m};
+    #pragma omp parallel for schedule(dynamic)
+    for (int b = 0; b < NUM_BLOCOS; b++) {
+        Aleatorio a = aleatorio_do_bloco(semente, b);
+        for (int64_t i = m * b / NUM_BLOCOS; i < m * (b + 1) / NUM_BLOCOS; i++) {
+            e.chaves[i] = chave_ou_laco((int)sortear(&a, n), (int)sortear(&a, n));
+        }
+    }
+    normalizar(&e);
+    return e;
+}
+
+// Cada aresta desce "escala" níveis da matriz de adjacência escolhendo um
+// quadrante com probabilidades a, b, c e 1 - a - b - c.
+Arestas gerar_rmat(int escala, int64_t m, double pa, double pb, double pc, uint64_t semente) {
+    Arestas e = {(uint64_t*)malloc(m * sizeof(uint64_t)), m};
+    #pragma omp parallel for schedule(dynamic)
+    for (int b = 0; b < NUM_BLOCOS; b++) {
+        Aleatorio a = aleatorio_do_bloco(semente, b);
+        for (int64_t i = m * b / NUM_BLOCOS; i < m * (b + 1) / NUM_BLOCOS; i++) {
+            int u = 0, v = 0;
+            for (int nivel = 0; nivel < escala; nivel++) {
+                double r = uniforme(&a);
+                int bit_u = r >= pa + pb;
+                int bit_v = (r >= pa && r < pa + pb) || r >= pa + pb + pc;
+                u = (u << 1) | bit_u;
+                v = (v << 1) | bit_v;
+            }
+            e.chaves[i] = chave_ou_laco(u, v);
+        }
+    }
+    normalizar(&e);
+    return e;
+}
+
+// Anexação preferencial pela lista de extremidades: sortear uma posição da
+// lista equivale a sortear um vértice com probabilidade proporcional ao grau.
+// Os grau + 1 primeiros vértices formam uma clique inicial.
+Arestas gerar_ba(int n, int grau, uint64_t semente) {
+    int inicial = grau + 1 < n ? grau + 1 : n;
+    int64_t m = (int64_t)inicial * (inicial - 1) / 2 + (int64_t)(n - inicial) * grau;
+    Arestas e = {(uint64_t*)malloc(m * sizeof(uint64_t)), 0};
+    int* extremidades = (int*)malloc(2 * m * sizeof(int));
+    int64_t num_extremidades = 0;
+    for (int u = 0; u < inicial; u++) {
+        for (int v = u + 1; v < inicial; v++) {
+            e.chaves[e.n++] = chave(u, v);
+            extremidades[num_extremidades++] = u;
+            extremidades[num_extremidades++] = v;
+        }
+    }
+    Aleatorio a = aleatorio_do_bloco(semente, 0);
+    int alvos[grau > 0 ? grau : 1];
+    for (int v = inicial; v < n; v++) {
+        int escolhidos = 0;
+        while (escolhidos < grau) {
+            int alvo = extremidades[sortear(&a, num_extremidades)];
+            bool repetido = false;
+            for (int i = 0; i < escolhidos && !repetido; i++) {
+                repetido = alvos[i] == alvo;
+            }
+            if (!repetido) {
+                alvos[escolhidos++] = alvo;
+            }
+        }
+        for (int i = 0; i < escolhidos; i++) {
+            e.chaves[e.n++] = chave(v, alvos[i]);
+            extremidades[num_extremidades++] = v;
+            extremidades[num_extremidades++] = alvos[i];
+        }
+    }
+    free(extremidades);
+    normalizar(&e);
+    return e;
+}
+
+// Os vértices de posição < cliques * tamanho formam as cliques; cada um dos
+// demais liga-se a um único vértice de posição anterior (floresta), o que não
+// cria triângulos. As posições são mapeadas para IDs por uma permutação.
+Arestas gerar_plantada(int n, int cliques, int tamanho, uint64_t semente) {
+    int nas_cliques = cliques * tamanho;
+    int64_t m = (int64_t)cliques * tamanho * (tamanho - 1) / 2 + (n - nas_cliques);
+    Arestas e = {(uint64_t*)malloc(m * sizeof(uint64_t)), m};
+
+    int* id = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        id[i] = i;
+    }
+    Aleatorio a = aleatorio_do_bloco(semente, 0);
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)sortear(&a, i + 1);
+        int troca = id[i];
+        id[i] = id[j];
+        id[j] = troca;
+    }
+
+    int64_t pares_por_clique = (int64_t)tamanho * (tamanho - 1) / 2;
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < cliques; c++) {
+        int64_t i = c * pares_por_clique;
+        for (int x = 0; x < tamanho; x++) {
+            for (int y = x + 1; y < tamanho; y++) {
+                e.chaves[i++] = chave(id[c * tamanho + x], id[c * tamanho + y]);
+            }
+        }
+    }
+    int64_t base = cliques * pares_por_clique;
+    int resto = n - nas_cliques;
+    #pragma omp parallel for schedule(dynamic)
+    for (int b = 0; b < NUM_BLOCOS; b++) {
+        Aleatorio ab = aleatorio_do_bloco(semente + 1, b);
+        for (int64_t i = (int64_t)resto * b / NUM_BLOCOS; i < (int64_t)resto * (b + 1) / NUM_BLOCOS; i++) {
+            int posicao = nas_cliques + (int)i;
+            e.chaves[base + i] = posicao == 0 ? UINT64_MAX
+                                              : chave(id[posicao], id[sortear(&ab, posicao)]);
+        }
+    }
+    free(id);
+    normalizar(&e);
+    return e;
+}
+
+double binomial(int n, int k) {
+    if (k < 0 || k > n) {
+        return 0;
+    }
+    double r = 1;
+    for (int i = 1; i <= k; i++) {
+        r = r * (n - k + i) / i;
+    }
+    return r;
+}
+
+bool gravar_texto(const char* saida, Arestas* e) {
+    char arquivo[256];
+    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", saida);
+    FILE* f = fopen(arquivo, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Erro ao criar %s\n", arquivo);
+        return false;
+    }
+    for (int64_t i = 0; i < e->n; i++) {
+        fprintf(f, "%u %u\n", (unsigned)(e->chaves[i] >> 32), (unsigned)(uint32_t)e->chaves[i]);
+    }
+    fclose(f);
+    printf("Gravado %s\n", arquivo);
+    return true;
+}
+
+bool gravar_binario(const char* saida, int V, Arestas* e) {
+    char arquivo[256];
+    snprintf(arquivo, sizeof(arquivo), "%s.bin", saida);
+    FILE* f = fopen(arquivo, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "Erro ao criar %s\n", arquivo);
+        return false;
+    }
+    int64_t cabecalho[2] = {V, e->n};
+    fwrite(MAGICO_BINARIO, 1, 8, f);
+    fwrite(cabecalho, sizeof(int64_t), 2, f);
+    int32_t par[2];
+    for (int64_t i = 0; i < e->n; i++) {
+        par[0] = (int32_t)(e->chaves[i] >> 32);
+        par[1] = (int32_t)(uint32_t)e->chaves[i];
+        fwrite(par, sizeof(int32_t), 2, f);
+    }
+    fclose(f);
+    printf("Gravado %s\n", arquivo);
+    return true;
+}
+
+// Procura "--nome=valor" nos argumentos opcionais.
+const char* obter_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+    size_t n = strlen(nome);
+    for (int i = primeiro; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, nome, n) == 0
+            && argv[i][n + 2] == '=') {
+            return argv[i] + n + 3;
+        }
+    }
+    return NULL;
+}
+
+const char* opcao_ou(int argc, char* argv[], const char* nome, const char* padrao) {
+    const char* valor = obter_opcao(argc, argv, 3, nome);
+    return valor != NULL ? valor : padrao;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s <er|rmat|ba|plantada> <saida> [--semente=N] [--formato=texto|binario|ambos] [--threads=N]\n"
+                        "  er:       --n=V --m=E\n"
+                        "  rmat:     --escala=S --fator=F [--a=0.57 --b=0.19 --c=0.19]\n"
+                        "  ba:       --n=V --grau=G\n"
+                        "  plantada: --n=V --cliques=C --tamanho=S\n", argv[0]);
+        return 1;
+    }
+    const char* modelo = argv[1];
+    const char* saida = argv[2];
+    uint64_t semente = strtoull(opcao_ou(argc, argv, "semente", "1"), NULL, 10);
+    const char* formato = opcao_ou(argc, argv, "formato", "texto");
+    const char* threads = obter_opcao(argc, argv, 3, "threads");
+    if (threads != NULL) {
+        omp_set_num_threads(atoi(threads));
+    }
+
+    double inicio = omp_get_wtime();
+    Arestas e;
+    int V;
+    int cliques = 0, tamanho = 0;
+    if (strcmp(modelo, "er") == 0) {
+        V = atoi(opcao_ou(argc, argv, "n", "10000"));
+        e = gerar_er(V, atoll(opcao_ou(argc, argv, "m", "100000")), semente);
+    } else if (strcmp(modelo, "rmat") == 0) {
+        int escala = atoi(opcao_ou(argc, argv, "escala", "14"));
+        if (escala < 1 || escala > 30) {
+            fprintf(stderr, "Escala fora do intervalo 1..30\n");
+            return 1;
+        }
+        V = 1 << escala;
+        int64_t m = (int64_t)atoi(opcao_ou(argc, argv, "fator", "16")) * V;
+        e = gerar_rmat(escala, m, atof(opcao_ou(argc, argv, "a", "0.57")), atof(opcao_ou(argc, argv, "b", "0.19")),
+                       atof(opcao_ou(argc, argv, "c", "0.19")), semente);
+    } else if (strcmp(modelo, "ba") == 0) {
+        V = atoi(opcao_ou(argc, argv, "n", "10000"));
+        e = gerar_ba(V, atoi(opcao_ou(argc, argv, "grau", "8")), semente);
+    } else if (strcmp(modelo, "plantada") == 0) {
+        V = atoi(opcao_ou(argc, argv, "n", "10000"));
+        cliques = atoi(opcao_ou(argc, argv, "cliques", "10"));
+        tamanho = atoi(opcao_ou(argc, argv, "tamanho", "8"));
+        if (cliques < 0 || tamanho < 1 || (int64_t)cliques * tamanho > V) {
+            fprintf(stderr, "As cliques não cabem em %d vértices\n", V);
+            return 1;
+        }
+        e = gerar_plantada(V, cliques, tamanho, semente);
+    } else {
+        fprintf(stderr, "Modelo desconhecido: %s\n", modelo);
+        return 1;
+    }
+    if (V < 1) {
+        fprintf(stderr, "Número de vértices inválido\n");
+        return 1;
+    }
+    double tempo = omp_get_wtime() - inicio;
+
+    int* grau = (int*)calloc(V, sizeof(int));
+    for (int64_t i = 0; i < e.n; i++) {
+        grau[e.chaves[i] >> 32]++;
+        grau[(uint32_t)e.chaves[i]]++;
+    }
+    int grau_maximo = 0;
+    for (int v = 0; v < V; v++) {
+        grau_maximo = grau[v] > grau_maximo ? grau[v] : grau_maximo;
+    }
+    free(grau);
+    printf("Modelo %s (semente %llu): %d vértices, %lld arestas, grau máximo %d\n",
+           modelo, (unsigned long long)semente, V, (long long)e.n, grau_maximo);
+    printf("Tempo de geração: %.6f segundos\n", tempo);
+
+    bool ok = true;
+    if (strcmp(formato, "texto") == 0 || strcmp(formato, "ambos") == 0) {
+        ok = ok && gravar_texto(saida, &e);
+    }
+    if (strcmp(formato, "binario") == 0 || strcmp(formato, "ambos") == 0) {
+        ok = ok && gravar_binario(saida, V, &e);
+    }
+
+    // Fora das cliques só há a floresta, então para k >= 3 todas as k-cliques
+    // estão dentro das cliques plantadas: cliques * C(tamanho, k).
+    if (strcmp(modelo, "plantada") == 0) {
+        char arquivo[256];
+        snprintf(arquivo, sizeof(arquivo), "%s.cliques", saida);
+        FILE* f = fopen(arquivo, "w");
+        for (int k = 3; k <= tamanho; k++) {
+            double esperado = cliques * binomial(tamanho, k);
+            printf("Cliques de tamanho %d esperadas: %.0f\n", k, esperado);
+            if (f != NULL) {
+                fprintf(f, "%d %.0f\n", k, esperado);
+            }
+        }
+        if (f != NULL) {
+            fclose(f);
+        }
+    }
+
+    free(e.chaves);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,1094 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Servidor de consultas de k-cliques: carrega e pré-processa grafos nomeados
+// uma vez, mantém um pool de threads aquecido e responde consultas de várias
+// conexões ao mesmo tempo por um socket Unix.
+//
+// Protocolo: um comando de texto por linha, uma resposta JSON por linha.
+//   carregar <nome> [dataset]        lê <dataset>.edgelist (padrão: <nome>)
+//   descarregar <nome>
+//   grafos
+//   contar <nome> <k>                número de k-cliques
+//   histograma <nome> <kmax>         número de cliques de cada tamanho até kmax
+//   vertice <nome> <k> <v>           k-cliques que contêm v
+//   vertices <nome> <k> [n]          os n vértices (padrão 10) em mais k-cliques
+//   aproximado <nome> <k> [amostras] estimativa por amostragem de raízes
+//   estatisticas                     latências por tipo de consulta
+//   encerrar
+// Toda resposta traz "latencia_ms"; contar, histograma, vertice e vertices
+// ficam em cache por (grafo, consulta), invalidado ao recarregar o grafo.
+//
+// Uso:
+//   servidor <socket> [--threads=N] [--carregar=nome[:dataset],...]
+//   servidor <socket> --enviar="comando[; comando...]"   (cliente)
+//
+// Compilação: gcc -O2 -pthread servidor.c -o servidor -lm
+
+#define MAX_GRAFOS 32
+#define MAX_K 64
+#define MAX_LINHA 1024
+#define MAX_RESPOSTA 8192
+#define MAX_LATENCIAS 4096
+
+// Tipo das contagens de cliques: 64 bits sem sinal; com -DCONTAGEM_128,
+// 128 bits (o printf não formata esse tipo, daí formatar_contagem).
+#ifdef CONTAGEM_128
+typedef unsigned __int128 contagem_t;
+#else
+typedef uint64_t contagem_t;
+#endif
+
+const char* formatar_contagem(contagem_t c, char* texto) {
+    char invertido[48];
+    int n = 0;
+    do {
+        invertido[n++] = (char)('0' + (int)(c % 10));
+        c /= 10;
+    } while (c > 0);
+    for (int i = 0; i < n; i++) {
+        texto[i] = invertido[n - 1 - i];
+    }
+    texto[n] = '\0';
+    return texto;
+}
+
+// Grafo residente: listas ordenadas sem repetições (CSR) e, para cada
+// vértice, a posição do primeiro vizinho com ID maior (a orientação usada na
+// contagem). "referencias" conta as consultas em andamento; um grafo
+// descarregado só é liberado quando a última termina.
+typedef struct Grafo {
+    char nome[64];
+    char dataset[100];
+    int V;
+    int64_t E;
+    int64_t* inicio;
+    int64_t* inicio_maiores;
+    int* arestas;
+    double tempo_carga;
+    int referencias;
+    bool descarregado;
+} Grafo;
+
+typedef enum TipoConsulta {
+    CONTAR,
+    HISTOGRAMA,
+    VERTICE,
+    VERTICES,
+    APROXIMADO,
+    OUTRAS,
+    NUM_TIPOS
+} TipoConsulta;
+
+const char* nomes_tipos[NUM_TIPOS] = {"contar", "histograma", "vertice", "vertices", "aproximado", "outras"};
+
+double agora(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+int comparar_int(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+int vertices_do_dataset(const char* dataset) {
+    if (strcmp(dataset, "citeseer") == 0) {
+        return 3312;
+    } else if (strcmp(dataset, "ca_astroph") == 0) {
+        return 18772;
+    } else if (strcmp(dataset, "dblp") == 0) {
+        return 317080;
+    }
+    // Datasets fora da lista (por exemplo, gerados pelo gerador.c): o maior
+    // ID em <dataset>.edgelist mais um.
+    char arquivo[110];
+    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+    FILE* f = fopen(arquivo, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    int u, v, maior = -1;
+    while (fscanf(f, "%d %d", &u, &v) == 2) {
+        maior = u > maior ? u : maior;
+        maior = v > maior ? v : maior;
+    }
+    fclose(f);
+    return maior + 1;
+}
+
+// Lê o edgelist em duas passadas (graus, depois preenchimento), ordena cada
+// lista e remove laços e arestas repetidas.
+Grafo* carregar_grafo(const char* nome, const char* dataset) {
+    double inicio_carga = agora();
+    int V = vertices_do_dataset(dataset);
+    if (V <= 0) {
+        return NULL;
+    }
+    char arquivo[110];
+    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+    FILE* f = fopen(arquivo, "r");
+    if (f == NULL) {
+        return NULL;
+    }
+
+    int64_t* grau = (int64_t*)calloc(V + 1, sizeof(int64_t));
+    int u, v;
+    while (fscanf(f, "%d %d", &u, &v) == 2) {
+        if (u < 0 || u >= V || v < 0 || v >= V || u == v) {
+            continue;
+        }
+        grau[u]++;
+        grau[v]++;
+    }
+
+    Grafo* g = (Grafo*)calloc(1, sizeof(Grafo));
+    snprintf(g->nome, sizeof(g->nome), "%s", nome);
+    snprintf(g->dataset, sizeof(g->dataset), "%s", dataset);
+    g->V = V;
+    g->inicio = (int64_t*)malloc((V + 1) * sizeof(int64_t));
+    g->inicio[0] = 0;
+    for (int i = 0; i < V; i++) {
+        g->inicio[i + 1] = g->inicio[i] + grau[i];
+        grau[i] = g->inicio[i];
+    }
+    g->arestas = (int*)malloc((g->inicio[V] > 0 ? g->inicio[V] : 1) * sizeof(int));
+
+    rewind(f);
+    while (fscanf(f, "%d %d", &u, &v) == 2) {
+        if (u < 0 || u >= V || v < 0 || v >= V || u == v) {
+            continue;
+        }
+        g->arestas[grau[u]++] = v;
+        g->arestas[grau[v]++] = u;
+    }
+    fclose(f);
+    free(grau);
+
+    // Compacta as listas no próprio vetor depois de ordenar.
+    g->inicio_maiores = (int64_t*)malloc(V * sizeof(int64_t));
+    int64_t escrita = 0;
+    for (int i = 0; i < V; i++) {
+        int* lista = g->arestas + g->inicio[i];
+        int n = (int)(g->inicio[i + 1] - g->inicio[i]);
+        qsort(lista, n, sizeof(int), comparar_int);
+        int64_t comeco = escrita;
+        g->inicio_maiores[i] = -1;
+        for (int j = 0; j < n; j++) {
+            if (j > 0 && lista[j] == lista[j - 1]) {
+                continue;
+            }
+            if (g->inicio_maiores[i] < 0 && lista[j] > i) {
+                g->inicio_maiores[i] = escrita;
+            }
+            g->arestas[escrita++] = lista[j];
+        }
+        g->inicio[i] = comeco;
+        if (g->inicio_maiores[i] < 0) {
+            g->inicio_maiores[i] = escrita;
+        }
+    }
+    g->inicio[V] = escrita;
+    g->E = escrita / 2;
+    g->tempo_carga = agora() - inicio_carga;
+    return g;
+}
+
+void liberar_grafo(Grafo* g) {
+    free(g->inicio);
+    free(g->inicio_maiores);
+    free(g->arestas);
+    free(g);
+}
+
+// Interseção de candidatos[0..n) com os vizinhos maiores que "w" (ambos
+// ordenados) em "saida"; devolve o tamanho.
+static int intersecao(Grafo* g, int w, const int* candidatos, int n, int* saida) {
+    const int* b = g->arestas + g->inicio_maiores[w];
+    int nb = (int)(g->inicio[w + 1] - g->inicio_maiores[w]);
+    int m = 0;
+    for (int i = 0, j = 0; i < n && j < nb;) {
+        if (candidatos[i] < b[j]) {
+            i++;
+        } else if (candidatos[i] > b[j]) {
+            j++;
+        } else {
+            saida[m++] = candidatos[i];
+            i++;
+            j++;
+        }
+    }
+    return m;
+}
+
+// Cliques de "restante" vértices tiradas de candidatos[0..n) (ordenados,
+// todos ligados aos vértices já escolhidos). Com "histograma", soma em
+// histograma[tamanho] também as cliques menores encontradas no caminho,
+// sendo "tamanho" o número de vértices já escolhidos.
+contagem_t contar_extensoes(Grafo* g, const int* candidatos, int n, int restante,
+                            contagem_t* histograma, int tamanho) {
+    if (restante == 0) {
+        return 1;
+    }
+    if (restante == 1 && histograma == NULL) {
+        return n;
+    }
+    contagem_t total = 0;
+    int* proximos = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        if (histograma == NULL && i + restante > n) {
+            break;
+        }
+        if (histograma != NULL) {
+            histograma[tamanho + 1]++;
+        }
+        if (restante == 1) {
+            total++;
+            continue;
+        }
+        int m = intersecao(g, candidatos[i], candidatos + i + 1, n - i - 1, proximos);
+        total += contar_extensoes(g, proximos, m, restante - 1, histograma, tamanho + 1);
+    }
+    free(proximos);
+    return total;
+}
+
+// k-cliques cujo menor vértice é "v".
+contagem_t cliques_da_raiz(Grafo* g, int v, int k, contagem_t* histograma) {
+    const int* maiores = g->arestas + g->inicio_maiores[v];
+    int n = (int)(g->inicio[v + 1] - g->inicio_maiores[v]);
+    if (histograma != NULL) {
+        histograma[1]++;
+    }
+    return contar_extensoes(g, maiores, n, k - 1, histograma, 1);
+}
+
+// k-cliques que contêm "v": as (k-1)-cliques da vizinhança completa.
+contagem_t cliques_do_vertice(Grafo* g, int v, int k) {
+    if (k == 1) {
+        return 1;
+    }
+    const int* vizinhos = g->arestas + g->inicio[v];
+    int n = (int)(g->inicio[v + 1] - g->inicio[v]);
+    return contar_extensoes(g, vizinhos, n, k - 1, NULL, 1);
+}
+
+// Uma consulta dividida em blocos de itens (raízes, vértices ou amostras)
+// que as threads do pool reservam na fila e acumulam de volta aqui.
+typedef struct Consulta {
+    Grafo* g;
+    TipoConsulta tipo;
+    int k;
+    int total_itens;
+    int proximo_item;
+    int bloco;
+    int itens_pendentes;
+    int* amostras;
+    contagem_t contagem;
+    contagem_t histograma[MAX_K + 2];
+    contagem_t* por_vertice;
+    double soma_quadrados;
+    pthread_mutex_t mutex;
+    pthread_cond_t pronta;
+    struct Consulta* prox;
+} Consulta;
+
+// Pool de threads: fila circular de consultas com itens por reservar.
+typedef struct Pool {
+    pthread_t* threads;
+    int num_threads;
+    Consulta* primeira;
+    Consulta* ultima;
+    bool encerrar;
+    pthread_mutex_t mutex;
+    pthread_cond_t trabalho;
+} Pool;
+
+Pool pool;
+
+void processar_bloco(Consulta* c, int inicio, int fim) {
+    contagem_t contagem = 0;
+    contagem_t histograma[MAX_K + 2];
+    double soma_quadrados = 0;
+    memset(histograma, 0, sizeof(histograma));
+    for (int i = inicio; i < fim; i++) {
+        if (c->tipo == CONTAR) {
+            contagem += cliques_da_raiz(c->g, i, c->k, NULL);
+        } else if (c->tipo == HISTOGRAMA) {
+            cliques_da_raiz(c->g, i, c->k, histograma);
+        } else if (c->tipo == VERTICES) {
+            c->por_vertice[i] = cliques_do_vertice(c->g, i, c->k);
+        } else if (c->tipo == APROXIMADO) {
+            contagem_t x = cliques_da_raiz(c->g, c->amostras[i], c->k, NULL);
+            contagem += x;
+            soma_quadrados += (double)x * (double)x;
+        }
+    }
+    pthread_mutex_lock(&c->mutex);
+    c->contagem += contagem;
+    c->soma_quadrados += soma_quadrados;
+    for (int i = 0; i <= MAX_K + 1; i++) {
+        c->histograma[i] += histograma[i];
+    }
+    c->itens_pendentes -= fim - inicio;
+    if (c->itens_pendentes == 0) {
+        pthread_cond_signal(&c->pronta);
+    }
+    pthread_mutex_unlock(&c->mutex);
+}
+
+// Cada thread reserva um bloco da consulta no início da fila e a devolve ao
+// fim dela, de modo que consultas concorrentes avançam juntas e uma consulta
+// pequena não espera uma grande terminar.
+void* trabalhador(void* arg) {
+    (void)arg;
+    while (true) {
+        pthread_mutex_lock(&pool.mutex);
+        while (pool.primeira == NULL && !pool.encerrar) {
+            pthread_cond_wait(&pool.trabalho, &pool.mutex);
+        }
+        if (pool.primeira == NULL) {
+            pthread_mutex_unlock(&pool.mutex);
+            return NULL;
+        }
+        Consulta* c = pool.primeira;
+        int inicio = c->proximo_item;
+        int fim = inicio + c->bloco < c->total_itens ? inicio + c->bloco : c->total_itens;
+        c->proximo_item = fim;
+        pool.primeira = c->prox;
+        if (pool.primeira == NULL) {
+            pool.ultima = NULL;
+        }
+        c->prox = NULL;
+        if (fim < c->total_itens) {
+            if (pool.ultima != NULL) {
+                pool.ultima->prox = c;
+            } else {
+                pool.primeira = c;
+            }
+            pool.ultima = c;
+        }
+        pthread_mutex_unlock(&pool.mutex);
+
+        processar_bloco(c, inicio, fim);
+    }
+}
+
+void iniciar_pool(int num_threads) {
+    pool.num_threads = num_threads;
+    pool.primeira = NULL;
+    pool.ultima = NULL;
+    pool.encerrar = false;
+    pthread_mutex_init(&pool.mutex, NULL);
+    pthread_cond_init(&pool.trabalho, NULL);
+    pool.threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    for (int i = 0; i < num_threads; i++) {
+        pthread_create(&pool.threads[i], NULL, trabalhador, NULL);
+    }
+}
+
+void encerrar_pool(void) {
+    pthread_mutex_lock(&pool.mutex);
+    pool.encerrar = true;
+    pthread_cond_broadcast(&pool.trabalho);
+    pthread_mutex_unlock(&pool.mutex);
+    for (int i = 0; i < pool.num_threads; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+    free(pool.threads);
+}
+
+// Enfileira a consulta e espera o pool terminar todos os itens.
+void executar_consulta(Consulta* c) {
+    c->proximo_item = 0;
+    c->itens_pendentes = c->total_itens;
+    c->contagem = 0;
+    c->soma_quadrados = 0;
+    memset(c->histograma, 0, sizeof(c->histograma));
+    if (c->total_itens == 0) {
+        return;
+    }
+    // Blocos pequenos o bastante para equilibrar raízes de custo desigual.
+    c->bloco = c->total_itens / (pool.num_threads * 16);
+    if (c->bloco < 1) {
+        c->bloco = 1;
+    }
+    pthread_mutex_init(&c->mutex, NULL);
+    pthread_cond_init(&c->pronta, NULL);
+    c->prox = NULL;
+
+    pthread_mutex_lock(&pool.mutex);
+    if (pool.ultima != NULL) {
+        pool.ultima->prox = c;
+    } else {
+        pool.primeira = c;
+    }
+    pool.ultima = c;
+    pthread_cond_broadcast(&pool.trabalho);
+    pthread_mutex_unlock(&pool.mutex);
+
+    pthread_mutex_lock(&c->mutex);
+    while (c->itens_pendentes > 0) {
+        pthread_cond_wait(&c->pronta, &c->mutex);
+    }
+    pthread_mutex_unlock(&c->mutex);
+    pthread_mutex_destroy(&c->mutex);
+    pthread_cond_destroy(&c->pronta);
+}
+
+// Grafos carregados, por nome.
+Grafo* grafos[MAX_GRAFOS];
+pthread_mutex_t mutex_grafos = PTHREAD_MUTEX_INITIALIZER;
+
+Grafo* adquirir_grafo(const char* nome) {
+    Grafo* g = NULL;
+    pthread_mutex_lock(&mutex_grafos);
+    for (int i = 0; i < MAX_GRAFOS; i++) {
+        if (grafos[i] != NULL && strcmp(grafos[i]->nome, nome) == 0) {
+            g = grafos[i];
+            g->referencias++;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mutex_grafos);
+    return g;
+}
+
+void soltar_grafo(Grafo* g) {
+    pthread_mutex_lock(&mutex_grafos);
+    bool liberar = --g->referencias == 0 && g->descarregado;
+    pthread_mutex_unlock(&mutex_grafos);
+    if (liberar) {
+        liberar_grafo(g);
+    }
+}
+
+// Tira o grafo da tabela; devolve false se não havia grafo com esse nome.
+bool retirar_grafo(const char* nome) {
+    Grafo* g = NULL;
+    pthread_mutex_lock(&mutex_grafos);
+    for (int i = 0; i < MAX_GRAFOS; i++) {
+        if (grafos[i] != NULL && strcmp(grafos[i]->nome, nome) == 0) {
+            g = grafos[i];
+            grafos[i] = NULL;
+            g->descarregado = true;
+            g->referencias++;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mutex_grafos);
+    if (g == NULL) {
+        return false;
+    }
+    soltar_grafo(g);
+    return true;
+}
+
+// Põe g na tabela numa só seção crítica: se já há um grafo com o mesmo nome,
+// g ocupa o lugar dele, que é marcado como descarregado. Assim duas cargas
+// simultâneas do mesmo nome não deixam duas entradas. Devolve false se não
+// há grafo com esse nome nem lugar livre.
+bool instalar_grafo(Grafo* g) {
+    Grafo* anterior = NULL;
+    int lugar = -1;
+    pthread_mutex_lock(&mutex_grafos);
+    for (int i = 0; i < MAX_GRAFOS; i++) {
+        if (grafos[i] != NULL && strcmp(grafos[i]->nome, g->nome) == 0) {
+            lugar = i;
+            anterior = grafos[i];
+            anterior->descarregado = true;
+            anterior->referencias++;
+            break;
+        }
+        if (grafos[i] == NULL && lugar < 0) {
+            lugar = i;
+        }
+    }
+    if (lugar >= 0) {
+        grafos[lugar] = g;
+    }
+    pthread_mutex_unlock(&mutex_grafos);
+    if (anterior != NULL) {
+        soltar_grafo(anterior);
+    }
+    return lugar >= 0;
+}
+
+// Cache de resultados: o corpo JSON da resposta por (grafo, tipo, k, extra).
+typedef struct EntradaCache {
+    char grafo[64];
+    TipoConsulta tipo;
+    int k;
+    int extra;
+    char* corpo;
+    struct EntradaCache* prox;
+} EntradaCache;
+
+EntradaCache* cache = NULL;
+pthread_mutex_t mutex_cache = PTHREAD_MUTEX_INITIALIZER;
+long long acertos_cache = 0;
+long long faltas_cache = 0;
+
+bool buscar_cache(const char* grafo, TipoConsulta tipo, int k, int extra, char* corpo, size_t tamanho) {
+    bool achou = false;
+    pthread_mutex_lock(&mutex_cache);
+    for (EntradaCache* e = cache; e != NULL; e = e->prox) {
+        if (e->tipo == tipo && e->k == k && e->extra == extra && strcmp(e->grafo, grafo) == 0) {
+            snprintf(corpo, tamanho, "%s", e->corpo);
+            achou = true;
+            break;
+        }
+    }
+    if (achou) {
+        acertos_cache++;
+    } else {
+        faltas_cache++;
+    }
+    pthread_mutex_unlock(&mutex_cache);
+    return achou;
+}
+
+// Guarda o resultado calculado sobre g, que ainda deve estar adquirido. Se g
+// já foi retirado (recarregado ou descarregado durante a consulta), o
+// resultado é de uma versão antiga e não entra no cache. A marca é lida com
+// mutex_cache preso: quem retira o grafo chama invalidar_cache depois, e essa
+// limpeza então vem necessariamente depois desta inserção.
+void guardar_cache(Grafo* g, TipoConsulta tipo, int k, int extra, const char* corpo) {
+    pthread_mutex_lock(&mutex_cache);
+    pthread_mutex_lock(&mutex_grafos);
+    bool descarregado = g->descarregado;
+    pthread_mutex_unlock(&mutex_grafos);
+    if (!descarregado) {
+        EntradaCache* e = (EntradaCache*)malloc(sizeof(EntradaCache));
+        snprintf(e->grafo, sizeof(e->grafo), "%s", g->nome);
+        e->tipo = tipo;
+        e->k = k;
+        e->extra = extra;
+        e->corpo = strdup(corpo);
+        e->prox = cache;
+        cache = e;
+    }
+    pthread_mutex_unlock(&mutex_cache);
+}
+
+void invalidar_cache(const char* grafo) {
+    pthread_mutex_lock(&mutex_cache);
+    EntradaCache** p = &cache;
+    while (*p != NULL) {
+        EntradaCache* e = *p;
+        if (strcmp(e->grafo, grafo) == 0) {
+            *p = e->prox;
+            free(e->corpo);
+            free(e);
+        } else {
+            p = &e->prox;
+        }
+    }
+    pthread_mutex_unlock(&mutex_cache);
+}
+
+// Latências recentes (em ms) por tipo de consulta, num anel de MAX_LATENCIAS.
+typedef struct Latencias {
+    long long n;
+    double soma;
+    double maxima;
+    double recentes[MAX_LATENCIAS];
+} Latencias;
+
+Latencias latencias[NUM_TIPOS];
+pthread_mutex_t mutex_latencias = PTHREAD_MUTEX_INITIALIZER;
+
+void registrar_latencia(TipoConsulta tipo, double ms) {
+    pthread_mutex_lock(&mutex_latencias);
+    Latencias* l = &latencias[tipo];
+    l->recentes[l->n % MAX_LATENCIAS] = ms;
+    l->n++;
+    l->soma += ms;
+    l->maxima = ms > l->maxima ? ms : l->maxima;
+    pthread_mutex_unlock(&mutex_latencias);
+}
+
+int comparar_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+void descrever_estatisticas(char* corpo, size_t tamanho) {
+    pthread_mutex_lock(&mutex_cache);
+    long long acertos = acertos_cache, faltas = faltas_cache;
+    pthread_mutex_unlock(&mutex_cache);
+    size_t n = snprintf(corpo, tamanho, "\"cache_resultados\":{\"acertos\":%lld,\"faltas\":%lld},\"consultas\":{",
+                        acertos, faltas);
+    pthread_mutex_lock(&mutex_latencias);
+    bool primeiro = true;
+    for (int t = 0; t < NUM_TIPOS && n < tamanho; t++) {
+        Latencias* l = &latencias[t];
+        if (l->n == 0) {
+            continue;
+        }
+        int m = l->n < MAX_LATENCIAS ? (int)l->n : MAX_LATENCIAS;
+        double* ordenadas = (double*)malloc(m * sizeof(double));
+        memcpy(ordenadas, l->recentes, m * sizeof(double));
+        qsort(ordenadas, m, sizeof(double), comparar_double);
+        n += snprintf(corpo + n, tamanho - n,
+                      "%s\"%s\":{\"n\":%lld,\"media_ms\":%.3f,\"p50_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f}",
+                      primeiro ? "" : ",", nomes_tipos[t], l->n, l->soma / l->n,
+                      ordenadas[m / 2], ordenadas[(int)(0.99 * (m - 1))], l->maxima);
+        free(ordenadas);
+        primeiro = false;
+    }
+    pthread_mutex_unlock(&mutex_latencias);
+    if (n < tamanho) {
+        snprintf(corpo + n, tamanho - n, "}");
+    }
+}
+
+typedef struct VerticeContagem {
+    int v;
+    contagem_t c;
+} VerticeContagem;
+
+int comparar_vertice_contagem(const void* a, const void* b) {
+    const VerticeContagem* x = (const VerticeContagem*)a;
+    const VerticeContagem* y = (const VerticeContagem*)b;
+    if (x->c != y->c) {
+        return x->c < y->c ? 1 : -1;
+    }
+    return x->v - y->v;
+}
+
+// splitmix64 para sortear as raízes de "aproximado".
+static inline uint64_t proximo_aleatorio(uint64_t* estado) {
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Escrito por "encerrar" numa thread de conexão e lido no laço de accept.
+atomic_bool servidor_ativo = true;
+int socket_escuta = -1;
+
+// Fecha a lista JSON iniciada em "corpo" com m bytes já escritos. Se não
+// couber em "tamanho", troca o corpo por uma mensagem de erro: uma resposta
+// cortada seria JSON inválido e não pode ir para o cliente nem para o cache.
+bool fechar_lista(char* corpo, size_t tamanho, size_t m, const char* dica) {
+    if (m + 1 >= tamanho) {
+        snprintf(corpo, tamanho, "resposta excede %zu bytes; %s", tamanho, dica);
+        return false;
+    }
+    snprintf(corpo + m, tamanho - m, "]");
+    return true;
+}
+
+// Um nome de grafo ou dataset vai sem escape nas respostas de sucesso.
+bool nome_valido(const char* nome) {
+    for (const unsigned char* p = (const unsigned char*)nome; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\' || *p < 0x20) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Executa um comando e escreve em "corpo" os campos da resposta (sem as
+// chaves externas). Devolve false em erro, com a mensagem em "corpo".
+bool executar_comando(char* linha, TipoConsulta* tipo, bool* do_cache, char* corpo, size_t tamanho) {
+    char* argumentos[8];
+    int n = 0;
+    char* posicao;
+    for (char* p = strtok_r(linha, " \t\r\n", &posicao); p != NULL && n < 8;
+         p = strtok_r(NULL, " \t\r\n", &posicao)) {
+        argumentos[n++] = p;
+    }
+    *tipo = OUTRAS;
+    *do_cache = false;
+    if (n == 0) {
+        snprintf(corpo, tamanho, "comando vazio");
+        return false;
+    }
+    const char* comando = argumentos[0];
+
+    if (strcmp(comando, "carregar") == 0 && n >= 2) {
+        const char* dataset = n >= 3 ? argumentos[2] : argumentos[1];
+        if (!nome_valido(argumentos[1]) || !nome_valido(dataset)) {
+            snprintf(corpo, tamanho, "nome inválido: %s", argumentos[1]);
+            return false;
+        }
+        Grafo* g = carregar_grafo(argumentos[1], dataset);
+        if (g == NULL) {
+            snprintf(corpo, tamanho, "não foi possível carregar %s", dataset);
+            return false;
+        }
+        // A resposta sai antes de instalar: depois disso outra carga do
+        // mesmo nome pode substituir e liberar g.
+        snprintf(corpo, tamanho, "\"grafo\":\"%s\",\"V\":%d,\"E\":%lld,\"carga_s\":%.6f",
+                 g->nome, g->V, (long long)g->E, g->tempo_carga);
+        if (!instalar_grafo(g)) {
+            liberar_grafo(g);
+            snprintf(corpo, tamanho, "limite de %d grafos atingido", MAX_GRAFOS);
+            return false;
+        }
+        invalidar_cache(argumentos[1]);
+        return true;
+    }
+    if (strcmp(comando, "descarregar") == 0 && n >= 2) {
+        if (!retirar_grafo(argumentos[1])) {
+            snprintf(corpo, tamanho, "grafo desconhecido: %s", argumentos[1]);
+            return false;
+        }
+        invalidar_cache(argumentos[1]);
+        snprintf(corpo, tamanho, "\"grafo\":\"%s\"", argumentos[1]);
+        return true;
+    }
+    if (strcmp(comando, "grafos") == 0) {
+        size_t m = snprintf(corpo, tamanho, "\"grafos\":[");
+        pthread_mutex_lock(&mutex_grafos);
+        bool primeiro = true;
+        for (int i = 0; i < MAX_GRAFOS && m < tamanho; i++) {
+            if (grafos[i] != NULL) {
+                m += snprintf(corpo + m, tamanho - m, "%s{\"nome\":\"%s\",\"dataset\":\"%s\",\"V\":%d,\"E\":%lld}",
+                              primeiro ? "" : ",", grafos[i]->nome, grafos[i]->dataset,
+                              grafos[i]->V, (long long)grafos[i]->E);
+                primeiro = false;
+            }
+        }
+        pthread_mutex_unlock(&mutex_grafos);
+        return fechar_lista(corpo, tamanho, m, "descarregue algum grafo");
+    }
+    if (strcmp(comando, "estatisticas") == 0) {
+        descrever_estatisticas(corpo, tamanho);
+        return true;
+    }
+    if (strcmp(comando, "encerrar") == 0) {
+        atomic_store(&servidor_ativo, false);
+        shutdown(socket_escuta, SHUT_RDWR);
+        snprintf(corpo, tamanho, "\"encerrando\":true");
+        return true;
+    }
+
+    TipoConsulta t = OUTRAS;
+    int minimo = 3;
+    if (strcmp(comando, "contar") == 0) {
+        t = CONTAR;
+    } else if (strcmp(comando, "histograma") == 0) {
+        t = HISTOGRAMA;
+    } else if (strcmp(comando, "vertice") == 0) {
+        t = VERTICE;
+        minimo = 4;
+    } else if (strcmp(comando, "vertices") == 0) {
+        t = VERTICES;
+    } else if (strcmp(comando, "aproximado") == 0) {
+        t = APROXIMADO;
+    }
+    if (t == OUTRAS || n < minimo) {
+        snprintf(corpo, tamanho, "comando inválido: %s", comando);
+        return false;
+    }
+    *tipo = t;
+    int k = atoi(argumentos[2]);
+    if (k < 1 || k > MAX_K) {
+        snprintf(corpo, tamanho, "k deve estar entre 1 e %d", MAX_K);
+        return false;
+    }
+    int extra = -1;
+    if (t == VERTICE) {
+        extra = atoi(argumentos[3]);
+    } else if (t == VERTICES) {
+        extra = n >= 4 ? atoi(argumentos[3]) : 10;
+    } else if (t == APROXIMADO) {
+        extra = n >= 4 ? atoi(argumentos[3]) : 1000;
+    }
+    if (t != APROXIMADO && buscar_cache(argumentos[1], t, k, extra, corpo, tamanho)) {
+        *do_cache = true;
+        return true;
+    }
+
+    Grafo* g = adquirir_grafo(argumentos[1]);
+    if (g == NULL) {
+        snprintf(corpo, tamanho, "grafo desconhecido: %s", argumentos[1]);
+        return false;
+    }
+    bool ok = true;
+    char texto[48];
+    Consulta c;
+    memset(&c, 0, sizeof(c));
+    c.g = g;
+    c.tipo = t;
+    c.k = k;
+    if (t == CONTAR) {
+        c.total_itens = g->V;
+        executar_consulta(&c);
+        snprintf(corpo, tamanho, "\"grafo\":\"%s\",\"k\":%d,\"contagem\":%s",
+                 g->nome, k, formatar_contagem(c.contagem, texto));
+    } else if (t == HISTOGRAMA) {
+        c.total_itens = g->V;
+        executar_consulta(&c);
+        size_t m = snprintf(corpo, tamanho, "\"grafo\":\"%s\",\"kmax\":%d,\"histograma\":[", g->nome, k);
+        for (int i = 1; i <= k && m < tamanho; i++) {
+            m += snprintf(corpo + m, tamanho - m, "%s%s", i > 1 ? "," : "",
+                          formatar_contagem(c.histograma[i], texto));
+        }
+        ok = fechar_lista(corpo, tamanho, m, "reduza kmax");
+    } else if (t == VERTICE) {
+        if (extra < 0 || extra >= g->V) {
+            snprintf(corpo, tamanho, "vértice fora do grafo: %d", extra);
+            ok = false;
+        } else {
+            snprintf(corpo, tamanho, "\"grafo\":\"%s\",\"k\":%d,\"vertice\":%d,\"contagem\":%s",
+                     g->nome, k, extra, formatar_contagem(cliques_do_vertice(g, extra, k), texto));
+        }
+    } else if (t == VERTICES) {
+        c.total_itens = g->V;
+        c.por_vertice = (contagem_t*)malloc((g->V > 0 ? g->V : 1) * sizeof(contagem_t));
+        executar_consulta(&c);
+        VerticeContagem* ordem = (VerticeContagem*)malloc((g->V > 0 ? g->V : 1) * sizeof(VerticeContagem));
+        for (int v = 0; v < g->V; v++) {
+            ordem[v].v = v;
+            ordem[v].c = c.por_vertice[v];
+        }
+        qsort(ordem, g->V, sizeof(VerticeContagem), comparar_vertice_contagem);
+        size_t m = snprintf(corpo, tamanho, "\"grafo\":\"%s\",\"k\":%d,\"maiores\":[", g->nome, k);
+        for (int i = 0; i < extra && i < g->V && m < tamanho; i++) {
+            m += snprintf(corpo + m, tamanho - m, "%s[%d,%s]", i > 0 ? "," : "", ordem[i].v,
+                          formatar_contagem(ordem[i].c, texto));
+        }
+        ok = fechar_lista(corpo, tamanho, m, "reduza n");
+        free(ordem);
+        free(c.por_vertice);
+    } else {
+        // Cada raiz sorteada contribui com as cliques em que é o menor
+        // vértice; a média vezes V estima o total, com erro padrão da média.
+        if (extra < 1 || g->V == 0) {
+            extra = 1;
+        }
+        uint64_t estado = (uint64_t)(agora() * 1e9);
+        c.total_itens = extra;
+        c.amostras = (int*)malloc(extra * sizeof(int));
+        for (int i = 0; i < extra; i++) {
+            c.amostras[i] = g->V > 0 ? (int)(proximo_aleatorio(&estado) % (uint64_t)g->V) : 0;
+        }
+        if (g->V > 0) {
+            executar_consulta(&c);
+        }
+        double media = (double)c.contagem / extra;
+        double variancia = c.soma_quadrados / extra - media * media;
+        double erro = extra > 1 && variancia > 0 ? g->V * sqrt(variancia / (extra - 1)) : 0;
+        snprintf(corpo, tamanho, "\"grafo\":\"%s\",\"k\":%d,\"amostras\":%d,\"estimativa\":%.1f,\"erro_padrao\":%.1f",
+                 g->nome, k, extra, media * g->V, erro);
+        free(c.amostras);
+    }
+    if (ok && t != APROXIMADO) {
+        guardar_cache(g, t, k, extra, corpo);
+    }
+    soltar_grafo(g);
+    return ok;
+}
+
+// Escreve "texto" como conteúdo de uma string JSON. Mensagens de erro
+// repetem o que o cliente enviou, então aspas, barras e caracteres de
+// controle precisam ser escapados.
+void escrever_texto_json(FILE* saida, const char* texto) {
+    for (const unsigned char* p = (const unsigned char*)texto; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            fprintf(saida, "\\%c", *p);
+        } else if (*p < 0x20) {
+            fprintf(saida, "\\u%04x", *p);
+        } else {
+            fputc(*p, saida);
+        }
+    }
+}
+
+// Atende uma conexão: lê comandos até o cliente fechar e responde cada um
+// numa linha JSON com a latência medida do recebimento à resposta pronta.
+void* atender_conexao(void* arg) {
+    int fd = (int)(intptr_t)arg;
+    FILE* entrada = fdopen(fd, "r");
+    FILE* saida = fdopen(dup(fd), "w");
+    char linha[MAX_LINHA];
+    char comando[MAX_LINHA];
+    char* corpo = (char*)malloc(MAX_RESPOSTA);
+    while (fgets(linha, sizeof(linha), entrada) != NULL) {
+        double inicio = agora();
+        snprintf(comando, sizeof(comando), "%s", linha);
+        comando[strcspn(comando, "\r\n")] = '\0';
+        TipoConsulta tipo;
+        bool do_cache;
+        bool ok = executar_comando(linha, &tipo, &do_cache, corpo, MAX_RESPOSTA);
+        double ms = (agora() - inicio) * 1e3;
+        registrar_latencia(tipo, ms);
+        if (ok) {
+            fprintf(saida, "{\"ok\":true,%s,\"cache\":%s,\"latencia_ms\":%.3f}\n",
+                    corpo, do_cache ? "true" : "false", ms);
+        } else {
+            fprintf(saida, "{\"ok\":false,\"erro\":\"");
+            escrever_texto_json(saida, corpo);
+            fprintf(saida, "\",\"latencia_ms\":%.3f}\n", ms);
+        }
+        fflush(saida);
+        printf("%-40s %s %.3f ms%s\n", comando, ok ? "ok" : "erro", ms, do_cache ? " (cache)" : "");
+        fflush(stdout);
+    }
+    free(corpo);
+    fclose(saida);
+    fclose(entrada);
+    return NULL;
+}
+
+// Cliente: envia os comandos separados por ';' e imprime as respostas.
+int enviar_comandos(const char* caminho, const char* comandos) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    snprintf(endereco.sun_path, sizeof(endereco.sun_path), "%s", caminho);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0) {
+        fprintf(stderr, "Erro ao conectar em %s: %s\n", caminho, strerror(errno));
+        return 1;
+    }
+    FILE* entrada = fdopen(fd, "r");
+    FILE* saida = fdopen(dup(fd), "w");
+    char* copia = strdup(comandos);
+    char* linha = NULL;
+    size_t capacidade = 0;
+    char* resto = copia;
+    for (char* cmd = strsep(&resto, ";"); cmd != NULL; cmd = strsep(&resto, ";")) {
+        while (*cmd == ' ') {
+            cmd++;
+        }
+        if (*cmd == '\0') {
+            continue;
+        }
+        fprintf(saida, "%s\n", cmd);
+        fflush(saida);
+        // getline: a resposta é lida inteira, qualquer que seja o tamanho,
+        // para não misturar o resto dela com a resposta do próximo comando.
+        if (getline(&linha, &capacidade, entrada) < 0) {
+            break;
+        }
+        fputs(linha, stdout);
+    }
+    free(linha);
+    free(copia);
+    fclose(saida);
+    fclose(entrada);
+    return 0;
+}
+
+bool tem_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+    for (int i = primeiro; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strcmp(argv[i] + 2, nome) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Procura "--nome=valor" nos argumentos opcionais.
+const char* obter_opcao(int argc, char* argv[], int primeiro, const char* nome) {
+    size_t n = strlen(nome);
+    for (int i = primeiro; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, nome, n) == 0
+            && argv[i][n + 2] == '=') {
+            return argv[i] + n + 3;
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s <socket> [--threads=N] [--carregar=nome[:dataset],...] | --enviar=\"comando[; comando...]\"\n", argv[0]);
+        return 1;
+    }
+    const char* caminho = argv[1];
+    const char* enviar = obter_opcao(argc, argv, 2, "enviar");
+    if (enviar != NULL) {
+        return enviar_comandos(caminho, enviar);
+    }
+
+    const char* opcao_threads = obter_opcao(argc, argv, 2, "threads");
+    int num_threads = opcao_threads != NULL ? atoi(opcao_threads) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    iniciar_pool(num_threads);
+
+    // --carregar: grafos já residentes antes de aceitar conexões.
+    const char* carregar = obter_opcao(argc, argv, 2, "carregar");
+    if (carregar != NULL) {
+        char* copia = strdup(carregar);
+        char* resto = copia;
+        for (char* item = strsep(&resto, ","); item != NULL; item = strsep(&resto, ",")) {
+            char comando[MAX_LINHA];
+            char* dois_pontos = strchr(item, ':');
+            if (dois_pontos != NULL) {
+                *dois_pontos = '\0';
+                snprintf(comando, sizeof(comando), "carregar %s %s", item, dois_pontos + 1);
+            } else {
+                snprintf(comando, sizeof(comando), "carregar %s", item);
+            }
+            char corpo[MAX_RESPOSTA];
+            TipoConsulta tipo;
+            bool do_cache;
+            bool ok = executar_comando(comando, &tipo, &do_cache, corpo, sizeof(corpo));
+            printf("Carga de %s: %s\n", item, corpo);
+            if (!ok) {
+                free(copia);
+                return 1;
+            }
+        }
+        free(copia);
+    }
+
+    socket_escuta = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    snprintf(endereco.sun_path, sizeof(endereco.sun_path), "%s", caminho);
+    unlink(caminho);
+    if (socket_escuta < 0 || bind(socket_escuta, (struct sockaddr*)&endereco, sizeof(endereco)) != 0
+        || listen(socket_escuta, 64) != 0) {
+        fprintf(stderr, "Erro ao abrir o socket %s: %s\n", caminho, strerror(errno));
+        return 1;
+    }
+    printf("Servidor em %s com %d threads\n", caminho, num_threads);
+    fflush(stdout);
+
+    while (atomic_load(&servidor_ativo)) {
+        int fd = accept(socket_escuta, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        pthread_t thread;
+        pthread_create(&thread, NULL, atender_conexao, (void*)(intptr_t)fd);
+        pthread_detach(thread);
+    }
+
+    close(socket_escuta);
+    unlink(caminho);
+    encerrar_pool();
+    printf("Servidor encerrado\n");
+    return 0;
+}
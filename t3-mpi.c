@@ -3,6 +3,8 @@
 #include <stdbool.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
+#include <unistd.h>
 #include <mpi.h>
 
 typedef struct Nodo {
@@ -15,12 +17,89 @@ typedef struct Grafo {
     Nodo** adj;
 } Grafo;
 
+// Tipo das contagens de cliques: 64 bits sem sinal; com -DCONTAGEM_128,
+// 128 bits (o printf não formata esse tipo, daí formatar_contagem).
+#ifdef CONTAGEM_128
+typedef unsigned __int128 contagem_t;
+#else
+typedef uint64_t contagem_t;
+#endif
+
+const char* formatar_contagem(contagem_t c, char* texto) {
+    char invertido[48];
+    int n = 0;
+    do {
+        invertido[n++] = (char)('0' + (int)(c % 10));
+        c /= 10;
+    } while (c > 0);
+    for (int i = 0; i < n; i++) {
+        texto[i] = invertido[n - 1 - i];
+    }
+    texto[n] = '\0';
+    return texto;
+}
+
+
+// Soma das contagens locais no rank 0. Em 128 bits, cada contagem vai como
+// duas palavras de 64 bits e a soma (com vai-um) é uma operação própria.
+#ifdef CONTAGEM_128
+static void somar_128(void* entrada, void* saida, int* n, MPI_Datatype* tipo) {
+    (void)tipo;
+    contagem_t* a = (contagem_t*)entrada;
+    contagem_t* b = (contagem_t*)saida;
+    for (int i = 0; i < *n; i++) {
+        b[i] += a[i];
+    }
+}
+#endif
+
+contagem_t reduzir_contagem(contagem_t local) {
+    contagem_t total = 0;
+#ifdef CONTAGEM_128
+    MPI_Datatype tipo;
+    MPI_Op soma;
+    MPI_Type_contiguous(2, MPI_UINT64_T, &tipo);
+    MPI_Type_commit(&tipo);
+    MPI_Op_create(somar_128, 1, &soma);
+    MPI_Reduce(&local, &total, 1, tipo, soma, 0, MPI_COMM_WORLD);
+    MPI_Op_free(&soma);
+    MPI_Type_free(&tipo);
+#else
+    MPI_Reduce(&local, &total, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+#endif
+    return total;
+}
+
 typedef struct Lista {
     int* vertices;
     int tamanho;
     struct Lista* prox;
 } Lista;
 
+// Contadores da busca do rank, compilados só com -DINSTRUMENTAR e reduzidos
+// entre os ranks no fim. Ocioso = espera pelo rank mais lento.
+#ifdef INSTRUMENTAR
+#define INSTR(x) x
+#define MAX_PROFUNDIDADE 32
+
+typedef struct Instrumentacao {
+    uint64_t quadros[MAX_PROFUNDIDADE];
+    uint64_t candidatos;
+    uint64_t sondagens;
+    uint64_t alocacoes;
+    double inicio;
+    double ocupado;
+} Instrumentacao;
+
+Instrumentacao instrumentacao;
+
+static inline void contar_quadro(int profundidade) {
+    instrumentacao.quadros[profundidade < MAX_PROFUNDIDADE ? profundidade : MAX_PROFUNDIDADE - 1]++;
+}
+#else
+#define INSTR(x)
+#endif
+
 Nodo* criar_nodo(int vertice) {
     Nodo* novo_nodo = (Nodo*)malloc(sizeof(Nodo));
     novo_nodo->vertice = vertice;
@@ -48,7 +127,8 @@ void adicionar_aresta(Grafo* g, int u, int v) {
     g->adj[v] = novo_nodo_u;
 }
 
-void carregar_grafo_de_arquivo(Grafo* g, const char* nome_arquivo) {
+// Devolve quantas arestas foram lidas (as fora do grafo não contam).
+int64_t carregar_grafo_de_arquivo(Grafo* g, const char* nome_arquivo) {
     FILE* arquivo = fopen(nome_arquivo, "r");
     if (arquivo == NULL) {
         printf("Erro ao abrir o arquivo!\n");
@@ -56,16 +136,20 @@ void carregar_grafo_de_arquivo(Grafo* g, const char* nome_arquivo) {
     }
 
     int u, v;
+    int64_t lidas = 0;
     while (fscanf(arquivo, "%d %d", &u, &v) != EOF) {
         if (u < 0 || u >= g->V || v < 0 || v >= g->V) {
             continue;
         }
         adicionar_aresta(g, u, v);
+        lidas++;
     }
     fclose(arquivo);
+    return lidas;
 }
 
 Lista* criar_lista(int* clique, int tamanho) {
+    INSTR(instrumentacao.alocacoes += 2);
     Lista* nova_lista = (Lista*)malloc(sizeof(Lista));
     nova_lista->vertices = (int*)malloc(tamanho * sizeof(int));
     for (int i = 0; i < tamanho; i++) {
@@ -90,6 +174,7 @@ Lista* desempilhar(Lista** cliques) {
 
 bool conexao_completa(Grafo* g, int* clique, int tamanho, int vizinho) {
     for (int i = 0; i < tamanho; i++) {
+        INSTR(instrumentacao.sondagens++);
         int vertice = clique[i];
         Nodo* adj = g->adj[vertice];
         bool conectado = false;
@@ -118,26 +203,213 @@ bool contem(int* array, int tamanho, int elemento) {
     return false;
 }
 
-int contagem_de_cliques_parallel(Grafo* g, int k, int rank, int num_procs) {
-    Lista* cliques = NULL;
-    int contador_local = 0;
+// Checkpoint da contagem (--checkpoint=arquivo). A unidade de trabalho é a
+// raiz: cada rank grava periodicamente em <arquivo>.<rank>, sem falar com os
+// outros, o bitmap das raízes que concluiu e a soma das cliques delas. O
+// arquivo base <arquivo> tem o que foi juntado na última retomada e a
+// geração vigente; arquivos de rank de outra geração já estão na base e são
+// ignorados. O campo "ranks" da base é o maior número de ranks entre as
+// gerações, para que a limpeza final alcance também os arquivos deixados por
+// execuções com mais ranks que a atual. Toda gravação vai para um temporário que substitui o anterior
+// com rename, então uma interrupção no meio deixa a versão anterior intacta.
+typedef struct Checkpoint {
+    char arquivo[160];
+    const char* dataset;
+    int k;
+    int V;
+    int geracao;
+    int ranks;
+    uint8_t* concluidas;
+    int num_concluidas;
+    contagem_t parcial;
+    double intervalo;
+    double ultima_gravacao;
+    int gravacoes;
+    double tempo_gravacao;
+    size_t bytes;
+} Checkpoint;
+
+contagem_t ler_contagem(const char* texto) {
+    contagem_t c = 0;
+    for (; *texto >= '0' && *texto <= '9'; texto++) {
+        c = c * 10 + (contagem_t)(*texto - '0');
+    }
+    return c;
+}
+
+static inline bool raiz_concluida(const uint8_t* concluidas, int v) {
+    return (concluidas[v >> 3] >> (v & 7)) & 1;
+}
+
+Checkpoint* criar_checkpoint(const char* arquivo, const char* dataset, int k, int V, double intervalo) {
+    Checkpoint* c = (Checkpoint*)calloc(1, sizeof(Checkpoint));
+    snprintf(c->arquivo, sizeof(c->arquivo), "%s", arquivo);
+    c->dataset = dataset;
+    c->k = k;
+    c->V = V;
+    c->intervalo = intervalo;
+    c->concluidas = (uint8_t*)calloc(((size_t)V + 7) / 8, 1);
+    c->ultima_gravacao = MPI_Wtime();
+    return c;
+}
+
+void liberar_checkpoint(Checkpoint* c) {
+    if (c != NULL) {
+        free(c->concluidas);
+        free(c);
+    }
+}
+
+bool gravar_checkpoint(Checkpoint* c) {
+    double inicio = MPI_Wtime();
+    char temporario[180];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", c->arquivo);
+    FILE* f = fopen(temporario, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "Erro ao criar %s\n", temporario);
+        return false;
+    }
+    char texto[48];
+    size_t tamanho_bitmap = ((size_t)c->V + 7) / 8;
+    int cabecalho = fprintf(f, "KCLIQUE-CHECKPOINT %s %d %d %d %d %d %s\n", c->dataset, c->k, c->V,
+                            c->geracao, c->ranks, c->num_concluidas, formatar_contagem(c->parcial, texto));
+    bool ok = cabecalho > 0 && fwrite(c->concluidas, 1, tamanho_bitmap, f) == tamanho_bitmap;
+    ok = fflush(f) == 0 && ok;
+    ok = fsync(fileno(f)) == 0 && ok;
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(temporario, c->arquivo) != 0) {
+        fprintf(stderr, "Erro ao gravar o checkpoint %s\n", c->arquivo);
+        unlink(temporario);
+        return false;
+    }
+    c->gravacoes++;
+    c->bytes += cabecalho + tamanho_bitmap;
+    c->ultima_gravacao = MPI_Wtime();
+    c->tempo_gravacao += c->ultima_gravacao - inicio;
+    return true;
+}
+
+// Junta "arquivo" em "c" se ele existe e, com geracao >= 0, é dessa geração.
+// Devolve false se não juntou; aborta se for de outra contagem.
+bool juntar_checkpoint(Checkpoint* c, const char* arquivo, int geracao) {
+    FILE* f = fopen(arquivo, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    char nome[110], texto[48];
+    int k_arquivo, V_arquivo, geracao_arquivo, ranks, num_concluidas;
+    if (fscanf(f, "KCLIQUE-CHECKPOINT %109s %d %d %d %d %d %47s", nome, &k_arquivo, &V_arquivo,
+               &geracao_arquivo, &ranks, &num_concluidas, texto) != 7 || fgetc(f) != '\n') {
+        fprintf(stderr, "Checkpoint inválido: %s\n", arquivo);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (strcmp(nome, c->dataset) != 0 || k_arquivo != c->k || V_arquivo != c->V) {
+        fprintf(stderr, "Checkpoint %s é de outra contagem (%s, k = %d, %d vértices)\n",
+                arquivo, nome, k_arquivo, V_arquivo);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (geracao >= 0 && geracao_arquivo != geracao) {
+        fclose(f);
+        return false;
+    }
+    size_t tamanho_bitmap = ((size_t)c->V + 7) / 8;
+    uint8_t* bitmap = (uint8_t*)malloc(tamanho_bitmap);
+    if (fread(bitmap, 1, tamanho_bitmap, f) != tamanho_bitmap) {
+        fprintf(stderr, "Checkpoint truncado: %s\n", arquivo);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    fclose(f);
+    for (size_t i = 0; i < tamanho_bitmap; i++) {
+        c->concluidas[i] |= bitmap[i];
+    }
+    free(bitmap);
+    c->num_concluidas += num_concluidas;
+    c->parcial += ler_contagem(texto);
+    if (geracao < 0) {
+        // Só a base define a geração e quantos arquivos de rank existem.
+        c->geracao = geracao_arquivo;
+        c->ranks = ranks;
+    }
+    return true;
+}
 
-    for (int v = rank; v < g->V; v += num_procs) {
-        int clique_inicial[] = {v};
-        empilhar(&cliques, clique_inicial, 1);
+// Retomada: o rank 0 junta a base com os arquivos de rank da geração dela
+// (quantos ranks houver na execução anterior), grava o resultado como base da
+// geração seguinte e o transmite. Cada rank recebe o bitmap das raízes já
+// concluídas e um checkpoint próprio, vazio, para a nova geração; a soma
+// parcial da base fica em "*parcial" e o número de arquivos de rank que podem
+// existir em "*ranks_arquivos" (ambos só no rank 0).
+Checkpoint* retomar_checkpoint(const char* arquivo, const char* dataset, int k, int V, double intervalo,
+                               int rank, int num_procs, uint8_t** concluidas, contagem_t* parcial,
+                               int* ranks_arquivos) {
+    Checkpoint* base = criar_checkpoint(arquivo, dataset, k, V, intervalo);
+    if (rank == 0) {
+        if (juntar_checkpoint(base, arquivo, -1)) {
+            int geracao = base->geracao, ranks = base->ranks;
+            for (int r = 0; r < ranks; r++) {
+                char arquivo_rank[180];
+                snprintf(arquivo_rank, sizeof(arquivo_rank), "%s.%d", arquivo, r);
+                juntar_checkpoint(base, arquivo_rank, geracao);
+            }
+            char texto[48];
+            printf("Retomando de %s (geração %d, %d ranks): %d de %d raízes concluídas, %s cliques\n",
+                   arquivo, geracao, ranks, base->num_concluidas, V, formatar_contagem(base->parcial, texto));
+        }
+        base->geracao++;
+        if (base->ranks < num_procs) {
+            base->ranks = num_procs;
+        }
+        *ranks_arquivos = base->ranks;
+        if (!gravar_checkpoint(base)) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
     }
+    MPI_Bcast(&base->geracao, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(base->concluidas, (V + 7) / 8, MPI_BYTE, 0, MPI_COMM_WORLD);
+
+    char arquivo_rank[180];
+    snprintf(arquivo_rank, sizeof(arquivo_rank), "%s.%d", arquivo, rank);
+    Checkpoint* c = criar_checkpoint(arquivo_rank, dataset, k, V, intervalo);
+    c->geracao = base->geracao;
+    c->ranks = num_procs;
+    *parcial = rank == 0 ? base->parcial : 0;
+    *concluidas = base->concluidas;
+    base->concluidas = NULL;
+    liberar_checkpoint(base);
+    return c;
+}
+
+// Marca a raiz "v" como concluída com "cliques" cliques e grava o arquivo do
+// rank se o intervalo já passou.
+void concluir_raiz(Checkpoint* c, int v, contagem_t cliques) {
+    c->concluidas[v >> 3] |= (uint8_t)(1 << (v & 7));
+    c->num_concluidas++;
+    c->parcial += cliques;
+    if (MPI_Wtime() - c->ultima_gravacao >= c->intervalo) {
+        gravar_checkpoint(c);
+    }
+}
+
+// Cliques com a raiz "v": a busca em profundidade a partir de {v}.
+contagem_t contar_raiz(Grafo* g, int k, int v) {
+    Lista* cliques = NULL;
+    contagem_t contador = 0;
+    int clique_inicial[] = {v};
+    empilhar(&cliques, clique_inicial, 1);
 
     while (cliques != NULL) {
         Lista* clique_atual = desempilhar(&cliques);
 
         if (clique_atual->tamanho == k) {
-            contador_local++;
+            contador++;
             free(clique_atual->vertices);
             free(clique_atual);
             continue;
         }
 
         int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
+        INSTR(contar_quadro(clique_atual->tamanho));
+        INSTR(instrumentacao.candidatos += g->V - ultimo_vertice - 1);
 
         for (int vizinho = ultimo_vertice + 1; vizinho < g->V; vizinho++) {
             if (!contem(clique_atual->vertices, clique_atual->tamanho, vizinho) 
@@ -154,11 +426,39 @@ int contagem_de_cliques_parallel(Grafo* g, int k, int rank, int num_procs) {
         free(clique_atual->vertices);
         free(clique_atual);
     }
+    return contador;
+}
+
+// A i-ésima raiz ainda não concluída fica com o rank i mod num_procs (sem
+// checkpoint, v = rank, rank + num_procs, ...). As raízes são percorridas da
+// maior para a menor, a ordem em que sairiam de uma pilha única.
+contagem_t contagem_de_cliques_parallel(Grafo* g, int k, int rank, int num_procs,
+                                        const uint8_t* concluidas, Checkpoint* c) {
+    contagem_t contador_local = 0;
 
-    int total_cliques = 0;
-    MPI_Reduce(&contador_local, &total_cliques, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    INSTR(instrumentacao.inicio = MPI_Wtime());
+    int* raizes = (int*)malloc((g->V / num_procs + 1) * sizeof(int));
+    int num_raizes = 0;
+    for (int v = 0, i = 0; v < g->V; v++) {
+        if (concluidas != NULL && raiz_concluida(concluidas, v)) {
+            continue;
+        }
+        if (i++ % num_procs == rank) {
+            raizes[num_raizes++] = v;
+        }
+    }
 
-    return total_cliques;
+    for (int i = num_raizes - 1; i >= 0; i--) {
+        contagem_t cliques = contar_raiz(g, k, raizes[i]);
+        contador_local += cliques;
+        if (c != NULL) {
+            concluir_raiz(c, raizes[i], cliques);
+        }
+    }
+    free(raizes);
+
+    INSTR(instrumentacao.ocupado = MPI_Wtime() - instrumentacao.inicio);
+    return reduzir_contagem(contador_local);
 }
 
 void liberar_grafo(Grafo* g) {
@@ -174,6 +474,952 @@ void liberar_grafo(Grafo* g) {
     free(g);
 }
 
+// Modo distribuído: cada rank possui uma faixa contígua de vértices
+// [limites[rank], limites[rank + 1]), escolhida para equilibrar o número de
+// arestas orientadas, e guarda só N+(v) (vizinhos de ID maior, ordenados) dos
+// vértices que possui. A busca a partir de v só consulta N+ de v e de seus
+// vizinhos em N+(v); com IDs em ordem de localidade, a maior parte deles cai
+// na própria faixa.
+typedef struct GrafoLocal {
+    int V;
+    int rank;
+    int num_procs;
+    int* limites;
+    int primeiro;
+    int num_locais;
+    int64_t* inicio;    // num_locais + 1, índice local i = v - primeiro
+    int* arestas;
+    // Linhas de outros ranks: tabela hash vértice -> posição em "linhas_remotas".
+    int* chaves;
+    int* posicoes;
+    int mascara;
+    int num_remotas;
+    int capacidade_remotas;
+    int** linhas_remotas;
+    int* graus_remotos;
+    size_t bytes_remotos;
+    // Acesso sob demanda via janelas RMA.
+    bool sob_demanda;
+    MPI_Win janela_inicio;
+    MPI_Win janela_arestas;
+    long buscas_remotas;
+} GrafoLocal;
+
+int comparar_int(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Lista ordenada e sem repetições dos vizinhos de v com ID maior.
+int montar_linha_orientada(Grafo* g, int v, int* linha) {
+    int n = 0;
+    for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+        if (adj->vertice > v) {
+            linha[n++] = adj->vertice;
+        }
+    }
+    qsort(linha, n, sizeof(int), comparar_int);
+    int unicos = 0;
+    for (int i = 0; i < n; i++) {
+        if (unicos == 0 || linha[unicos - 1] != linha[i]) {
+            linha[unicos++] = linha[i];
+        }
+    }
+    return unicos;
+}
+
+static inline uint32_t espalhar(int x) {
+    return (uint32_t)x * 2654435761u;
+}
+
+void inserir_linha_remota(GrafoLocal* gl, int v, int* linha, int grau) {
+    if (2 * (gl->num_remotas + 1) > gl->mascara + 1) {
+        int nova_capacidade = 2 * (gl->mascara + 1);
+        int* chaves = (int*)malloc(nova_capacidade * sizeof(int));
+        int* posicoes = (int*)malloc(nova_capacidade * sizeof(int));
+        memset(chaves, -1, nova_capacidade * sizeof(int));
+        for (int i = 0; i <= gl->mascara; i++) {
+            if (gl->chaves[i] != -1) {
+                uint32_t j = espalhar(gl->chaves[i]) & (nova_capacidade - 1);
+                while (chaves[j] != -1) {
+                    j = (j + 1) & (nova_capacidade - 1);
+                }
+                chaves[j] = gl->chaves[i];
+                posicoes[j] = gl->posicoes[i];
+            }
+        }
+        free(gl->chaves);
+        free(gl->posicoes);
+        gl->chaves = chaves;
+        gl->posicoes = posicoes;
+        gl->mascara = nova_capacidade - 1;
+    }
+    if (gl->num_remotas == gl->capacidade_remotas) {
+        gl->capacidade_remotas = gl->capacidade_remotas * 2 + 16;
+        gl->linhas_remotas = (int**)realloc(gl->linhas_remotas, gl->capacidade_remotas * sizeof(int*));
+        gl->graus_remotos = (int*)realloc(gl->graus_remotos, gl->capacidade_remotas * sizeof(int));
+    }
+    uint32_t j = espalhar(v) & gl->mascara;
+    while (gl->chaves[j] != -1) {
+        j = (j + 1) & gl->mascara;
+    }
+    gl->chaves[j] = v;
+    gl->posicoes[j] = gl->num_remotas;
+    gl->linhas_remotas[gl->num_remotas] = linha;
+    gl->graus_remotos[gl->num_remotas] = grau;
+    gl->num_remotas++;
+    gl->bytes_remotos += grau * sizeof(int) + sizeof(int*) + 3 * sizeof(int);
+}
+
+// Busca a linha de v no dono com MPI_Get (a época de acesso passivo é aberta
+// por MPI_Win_lock_all antes da contagem).
+int dono_de(GrafoLocal* gl, int v) {
+    int lo = 0, hi = gl->num_procs - 1;
+    while (lo < hi) {
+        int meio = (lo + hi + 1) >> 1;
+        if (gl->limites[meio] <= v) {
+            lo = meio;
+        } else {
+            hi = meio - 1;
+        }
+    }
+    return lo;
+}
+
+void buscar_linha_remota(GrafoLocal* gl, int v) {
+    int dono = dono_de(gl, v);
+    MPI_Aint local = v - gl->limites[dono];
+    int64_t limites[2];
+    MPI_Get(limites, 2, MPI_INT64_T, dono, local, 2, MPI_INT64_T, gl->janela_inicio);
+    MPI_Win_flush(dono, gl->janela_inicio);
+    int grau = (int)(limites[1] - limites[0]);
+    int* linha = (int*)malloc((grau > 0 ? grau : 1) * sizeof(int));
+    if (grau > 0) {
+        MPI_Get(linha, grau, MPI_INT, dono, (MPI_Aint)limites[0], grau, MPI_INT, gl->janela_arestas);
+        MPI_Win_flush(dono, gl->janela_arestas);
+    }
+    gl->buscas_remotas++;
+    inserir_linha_remota(gl, v, linha, grau);
+}
+
+const int* linha_de(GrafoLocal* gl, int v, int* grau) {
+    if (v >= gl->primeiro && v < gl->primeiro + gl->num_locais) {
+        int i = v - gl->primeiro;
+        *grau = (int)(gl->inicio[i + 1] - gl->inicio[i]);
+        return gl->arestas + gl->inicio[i];
+    }
+    while (true) {
+        uint32_t j = espalhar(v) & gl->mascara;
+        while (gl->chaves[j] != -1) {
+            if (gl->chaves[j] == v) {
+                int p = gl->posicoes[j];
+                *grau = gl->graus_remotos[p];
+                return gl->linhas_remotas[p];
+            }
+            j = (j + 1) & gl->mascara;
+        }
+        if (!gl->sob_demanda) {
+            fprintf(stderr, "Rank %d: linha do vértice %d ausente\n", gl->rank, v);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        buscar_linha_remota(gl, v);
+    }
+}
+
+bool linha_contem(const int* linha, int grau, int x) {
+    int lo = 0, hi = grau - 1;
+    while (lo <= hi) {
+        int meio = (lo + hi) >> 1;
+        if (linha[meio] == x) {
+            return true;
+        }
+        if (linha[meio] < x) {
+            lo = meio + 1;
+        } else {
+            hi = meio - 1;
+        }
+    }
+    return false;
+}
+
+GrafoLocal* criar_grafo_local(int V, int rank, int num_procs, int* limites) {
+    GrafoLocal* gl = (GrafoLocal*)calloc(1, sizeof(GrafoLocal));
+    gl->V = V;
+    gl->rank = rank;
+    gl->num_procs = num_procs;
+    gl->limites = limites;
+    gl->primeiro = limites[rank];
+    gl->num_locais = limites[rank + 1] - limites[rank];
+    gl->mascara = 63;
+    gl->chaves = (int*)malloc(64 * sizeof(int));
+    gl->posicoes = (int*)malloc(64 * sizeof(int));
+    memset(gl->chaves, -1, 64 * sizeof(int));
+    return gl;
+}
+
+// Faixas contíguas com pesos (grau orientado + 1) aproximadamente iguais.
+void particionar_faixas(const int* graus, int V, int num_procs, int* limites) {
+    int64_t total = 0;
+    for (int v = 0; v < V; v++) {
+        total += graus[v] + 1;
+    }
+    int64_t acumulado = 0;
+    int r = 1;
+    limites[0] = 0;
+    for (int v = 0; v < V && r < num_procs; v++) {
+        acumulado += graus[v] + 1;
+        while (r < num_procs && acumulado * num_procs >= total * r) {
+            limites[r++] = v + 1;
+        }
+    }
+    while (r <= num_procs) {
+        limites[r++] = V;
+    }
+}
+
+// Rank 0 lê o arquivo, particiona os vértices e envia a cada rank apenas as
+// linhas orientadas da faixa dele; depois descarta o grafo completo.
+GrafoLocal* distribuir_grafo(const char* arquivo, int V, int rank, int num_procs) {
+    int* limites = (int*)malloc((num_procs + 1) * sizeof(int));
+    int* graus_todos = NULL;
+    int* arestas_todas = NULL;
+    int* contagens = NULL;
+    int* deslocamentos = NULL;
+    int* contagens_arestas = NULL;
+    int* deslocamentos_arestas = NULL;
+    if (rank == 0) {
+        Grafo* g = criar_grafo(V);
+        carregar_grafo_de_arquivo(g, arquivo);
+        contagens = (int*)calloc(num_procs, sizeof(int));
+        deslocamentos = (int*)calloc(num_procs, sizeof(int));
+        contagens_arestas = (int*)calloc(num_procs, sizeof(int));
+        deslocamentos_arestas = (int*)calloc(num_procs, sizeof(int));
+        graus_todos = (int*)malloc(V * sizeof(int));
+        int* linhas_por_vertice = (int*)malloc(V * sizeof(int));
+        int64_t total = 0;
+        for (int v = 0; v < V; v++) {
+            int n = 0;
+            for (Nodo* adj = g->adj[v]; adj != NULL; adj = adj->prox) {
+                n++;
+            }
+            linhas_por_vertice[v] = n;
+            total += n;
+        }
+        int* tmp = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+        int64_t pos_tmp = 0;
+        int* inicio_tmp = (int*)malloc(V * sizeof(int));
+        for (int v = 0; v < V; v++) {
+            inicio_tmp[v] = (int)pos_tmp;
+            graus_todos[v] = montar_linha_orientada(g, v, tmp + pos_tmp);
+            pos_tmp += linhas_por_vertice[v];
+        }
+        liberar_grafo(g);
+        particionar_faixas(graus_todos, V, num_procs, limites);
+
+        // Compacta as linhas: as arestas de cada rank ficam contíguas.
+        int64_t total_orientado = 0;
+        for (int v = 0; v < V; v++) {
+            total_orientado += graus_todos[v];
+        }
+        arestas_todas = (int*)malloc((total_orientado > 0 ? total_orientado : 1) * sizeof(int));
+        int64_t pos_arestas = 0;
+        for (int r = 0; r < num_procs; r++) {
+            deslocamentos[r] = limites[r];
+            contagens[r] = limites[r + 1] - limites[r];
+            deslocamentos_arestas[r] = (int)pos_arestas;
+            for (int v = limites[r]; v < limites[r + 1]; v++) {
+                memcpy(arestas_todas + pos_arestas, tmp + inicio_tmp[v], graus_todos[v] * sizeof(int));
+                pos_arestas += graus_todos[v];
+            }
+            contagens_arestas[r] = (int)(pos_arestas - deslocamentos_arestas[r]);
+        }
+        free(tmp);
+        free(inicio_tmp);
+        free(linhas_por_vertice);
+    }
+
+    MPI_Bcast(limites, num_procs + 1, MPI_INT, 0, MPI_COMM_WORLD);
+    GrafoLocal* gl = criar_grafo_local(V, rank, num_procs, limites);
+    int* graus = (int*)malloc((gl->num_locais > 0 ? gl->num_locais : 1) * sizeof(int));
+    MPI_Scatterv(graus_todos, contagens, deslocamentos, MPI_INT,
+                 graus, gl->num_locais, MPI_INT, 0, MPI_COMM_WORLD);
+    gl->inicio = (int64_t*)malloc((gl->num_locais + 1) * sizeof(int64_t));
+    gl->inicio[0] = 0;
+    for (int i = 0; i < gl->num_locais; i++) {
+        gl->inicio[i + 1] = gl->inicio[i] + graus[i];
+    }
+    gl->arestas = (int*)malloc((gl->inicio[gl->num_locais] > 0 ? gl->inicio[gl->num_locais] : 1) * sizeof(int));
+    MPI_Scatterv(arestas_todas, contagens_arestas, deslocamentos_arestas, MPI_INT,
+                 gl->arestas, (int)gl->inicio[gl->num_locais], MPI_INT, 0, MPI_COMM_WORLD);
+
+    free(graus);
+    free(graus_todos);
+    free(arestas_todas);
+    free(contagens);
+    free(deslocamentos);
+    free(contagens_arestas);
+    free(deslocamentos_arestas);
+    return gl;
+}
+
+// Pede a cada dono, de uma vez, as linhas N+(u) de todo u em N+(raiz) que
+// não seja local (MPI_Alltoallv de pedidos, graus e arestas).
+void trocar_vizinhanca(GrafoLocal* gl) {
+    int P = gl->num_procs;
+    int64_t total = gl->inicio[gl->num_locais];
+    int* necessarios = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    int n = 0;
+    for (int64_t i = 0; i < total; i++) {
+        if (dono_de(gl, gl->arestas[i]) != gl->rank) {
+            necessarios[n++] = gl->arestas[i];
+        }
+    }
+    qsort(necessarios, n, sizeof(int), comparar_int);
+    int unicos = 0;
+    for (int i = 0; i < n; i++) {
+        if (unicos == 0 || necessarios[unicos - 1] != necessarios[i]) {
+            necessarios[unicos++] = necessarios[i];
+        }
+    }
+
+    int* envios = (int*)calloc(P, sizeof(int));
+    int* recebimentos = (int*)calloc(P, sizeof(int));
+    int* desl_envio = (int*)calloc(P, sizeof(int));
+    int* desl_receb = (int*)calloc(P, sizeof(int));
+    for (int i = 0; i < unicos; i++) {
+        envios[dono_de(gl, necessarios[i])]++;
+    }
+    for (int r = 1; r < P; r++) {
+        desl_envio[r] = desl_envio[r - 1] + envios[r - 1];
+    }
+    int* pedidos = (int*)malloc((unicos > 0 ? unicos : 1) * sizeof(int));
+    int* cursor = (int*)malloc(P * sizeof(int));
+    memcpy(cursor, desl_envio, P * sizeof(int));
+    for (int i = 0; i < unicos; i++) {
+        pedidos[cursor[dono_de(gl, necessarios[i])]++] = necessarios[i];
+    }
+    MPI_Alltoall(envios, 1, MPI_INT, recebimentos, 1, MPI_INT, MPI_COMM_WORLD);
+    int total_receb = 0;
+    for (int r = 0; r < P; r++) {
+        desl_receb[r] = total_receb;
+        total_receb += recebimentos[r];
+    }
+    int* recebidos = (int*)malloc((total_receb > 0 ? total_receb : 1) * sizeof(int));
+    MPI_Alltoallv(pedidos, envios, desl_envio, MPI_INT,
+                  recebidos, recebimentos, desl_receb, MPI_INT, MPI_COMM_WORLD);
+
+    // Responde: graus dos vértices pedidos e, em seguida, as linhas.
+    int* graus_resp = (int*)malloc((total_receb > 0 ? total_receb : 1) * sizeof(int));
+    int* arestas_resp_cont = (int*)calloc(P, sizeof(int));
+    int* arestas_resp_desl = (int*)calloc(P, sizeof(int));
+    int64_t total_resp = 0;
+    for (int r = 0; r < P; r++) {
+        arestas_resp_desl[r] = (int)total_resp;
+        for (int i = desl_receb[r]; i < desl_receb[r] + recebimentos[r]; i++) {
+            int local = recebidos[i] - gl->primeiro;
+            graus_resp[i] = (int)(gl->inicio[local + 1] - gl->inicio[local]);
+            arestas_resp_cont[r] += graus_resp[i];
+        }
+        total_resp += arestas_resp_cont[r];
+    }
+    int* arestas_resp = (int*)malloc((total_resp > 0 ? total_resp : 1) * sizeof(int));
+    for (int i = 0, pos = 0; i < total_receb; i++) {
+        int local = recebidos[i] - gl->primeiro;
+        memcpy(arestas_resp + pos, gl->arestas + gl->inicio[local], graus_resp[i] * sizeof(int));
+        pos += graus_resp[i];
+    }
+
+    int* graus_pedidos = (int*)malloc((unicos > 0 ? unicos : 1) * sizeof(int));
+    MPI_Alltoallv(graus_resp, recebimentos, desl_receb, MPI_INT,
+                  graus_pedidos, envios, desl_envio, MPI_INT, MPI_COMM_WORLD);
+    int* arestas_cont = (int*)calloc(P, sizeof(int));
+    int* arestas_desl = (int*)calloc(P, sizeof(int));
+    int64_t total_chegada = 0;
+    for (int r = 0; r < P; r++) {
+        arestas_desl[r] = (int)total_chegada;
+        for (int i = desl_envio[r]; i < desl_envio[r] + envios[r]; i++) {
+            arestas_cont[r] += graus_pedidos[i];
+        }
+        total_chegada += arestas_cont[r];
+    }
+    int* arestas_chegada = (int*)malloc((total_chegada > 0 ? total_chegada : 1) * sizeof(int));
+    MPI_Alltoallv(arestas_resp, arestas_resp_cont, arestas_resp_desl, MPI_INT,
+                  arestas_chegada, arestas_cont, arestas_desl, MPI_INT, MPI_COMM_WORLD);
+
+    for (int i = 0, pos = 0; i < unicos; i++) {
+        int* linha = (int*)malloc((graus_pedidos[i] > 0 ? graus_pedidos[i] : 1) * sizeof(int));
+        memcpy(linha, arestas_chegada + pos, graus_pedidos[i] * sizeof(int));
+        pos += graus_pedidos[i];
+        inserir_linha_remota(gl, pedidos[i], linha, graus_pedidos[i]);
+    }
+
+    free(necessarios);
+    free(envios);
+    free(recebimentos);
+    free(desl_envio);
+    free(desl_receb);
+    free(pedidos);
+    free(cursor);
+    free(recebidos);
+    free(graus_resp);
+    free(arestas_resp_cont);
+    free(arestas_resp_desl);
+    free(arestas_resp);
+    free(graus_pedidos);
+    free(arestas_cont);
+    free(arestas_desl);
+    free(arestas_chegada);
+}
+
+void abrir_janelas(GrafoLocal* gl) {
+    gl->sob_demanda = true;
+    if (gl->num_procs == 1) {
+        return;
+    }
+    MPI_Win_create(gl->inicio, (gl->num_locais + 1) * sizeof(int64_t), sizeof(int64_t),
+                   MPI_INFO_NULL, MPI_COMM_WORLD, &gl->janela_inicio);
+    MPI_Win_create(gl->arestas, gl->inicio[gl->num_locais] * sizeof(int), sizeof(int),
+                   MPI_INFO_NULL, MPI_COMM_WORLD, &gl->janela_arestas);
+    MPI_Win_lock_all(0, gl->janela_inicio);
+    MPI_Win_lock_all(0, gl->janela_arestas);
+}
+
+void fechar_janelas(GrafoLocal* gl) {
+    if (gl->num_procs == 1) {
+        return;
+    }
+    MPI_Win_unlock_all(gl->janela_inicio);
+    MPI_Win_unlock_all(gl->janela_arestas);
+    MPI_Win_free(&gl->janela_inicio);
+    MPI_Win_free(&gl->janela_arestas);
+}
+
+size_t bytes_grafo_local(GrafoLocal* gl) {
+    return (gl->num_locais + 1) * sizeof(int64_t) + gl->inicio[gl->num_locais] * sizeof(int)
+         + (gl->mascara + 1) * 2 * sizeof(int) + gl->bytes_remotos;
+}
+
+void liberar_grafo_local(GrafoLocal* gl) {
+    for (int i = 0; i < gl->num_remotas; i++) {
+        free(gl->linhas_remotas[i]);
+    }
+    free(gl->linhas_remotas);
+    free(gl->graus_remotos);
+    free(gl->chaves);
+    free(gl->posicoes);
+    free(gl->inicio);
+    free(gl->arestas);
+    free(gl->limites);
+    free(gl);
+}
+
+// Cliques com a raiz "v" no modo distribuído.
+contagem_t contar_raiz_distribuida(GrafoLocal* gl, int k, int v) {
+    Lista* cliques = NULL;
+    contagem_t contador = 0;
+    int clique_inicial[] = {v};
+    empilhar(&cliques, clique_inicial, 1);
+
+    while (cliques != NULL) {
+        Lista* clique_atual = desempilhar(&cliques);
+
+        if (clique_atual->tamanho == k) {
+            contador++;
+            free(clique_atual->vertices);
+            free(clique_atual);
+            continue;
+        }
+
+        int ultimo_vertice = clique_atual->vertices[clique_atual->tamanho - 1];
+        int num_candidatos;
+        const int* candidatos = linha_de(gl, ultimo_vertice, &num_candidatos);
+        INSTR(contar_quadro(clique_atual->tamanho));
+        INSTR(instrumentacao.candidatos += num_candidatos);
+        for (int c = 0; c < num_candidatos; c++) {
+            int vizinho = candidatos[c];
+            bool conectado = true;
+            for (int j = 0; j < clique_atual->tamanho - 1 && conectado; j++) {
+                int grau;
+                INSTR(instrumentacao.sondagens++);
+                const int* linha = linha_de(gl, clique_atual->vertices[j], &grau);
+                conectado = linha_contem(linha, grau, vizinho);
+            }
+            if (conectado) {
+                int nova_clique[clique_atual->tamanho + 1];
+                memcpy(nova_clique, clique_atual->vertices, clique_atual->tamanho * sizeof(int));
+                nova_clique[clique_atual->tamanho] = vizinho;
+                empilhar(&cliques, nova_clique, clique_atual->tamanho + 1);
+                // "candidatos" pode ter sido realocado por uma busca remota.
+                candidatos = linha_de(gl, ultimo_vertice, &num_candidatos);
+            }
+        }
+
+        free(clique_atual->vertices);
+        free(clique_atual);
+    }
+    return contador;
+}
+
+// Cada rank conta as raízes da própria faixa que ainda não foram concluídas
+// (com outro número de ranks, as faixas mudam e o bitmap global continua
+// valendo).
+contagem_t contagem_de_cliques_distribuida(GrafoLocal* gl, int k, const uint8_t* concluidas, Checkpoint* c) {
+    contagem_t contador_local = 0;
+
+    INSTR(instrumentacao.inicio = MPI_Wtime());
+    for (int v = gl->primeiro; v < gl->primeiro + gl->num_locais; v++) {
+        if (concluidas != NULL && raiz_concluida(concluidas, v)) {
+            continue;
+        }
+        contagem_t cliques = contar_raiz_distribuida(gl, k, v);
+        contador_local += cliques;
+        if (c != NULL) {
+            concluir_raiz(c, v, cliques);
+        }
+    }
+
+    INSTR(instrumentacao.ocupado = MPI_Wtime() - instrumentacao.inicio);
+    return reduzir_contagem(contador_local);
+}
+
+#ifdef INSTRUMENTAR
+// Soma os contadores no rank 0 e junta o tempo ocupado de cada rank. Com
+// trilha, cada rank vira um processo na trilha do Chrome, com o intervalo
+// ocupado medido a partir da barreira que antecede a contagem.
+void relatar_instrumentacao(int rank, int num_procs, double origem, const char* trilha) {
+    uint64_t locais[MAX_PROFUNDIDADE + 3], totais[MAX_PROFUNDIDADE + 3];
+    memcpy(locais, instrumentacao.quadros, sizeof(instrumentacao.quadros));
+    locais[MAX_PROFUNDIDADE] = instrumentacao.candidatos;
+    locais[MAX_PROFUNDIDADE + 1] = instrumentacao.sondagens;
+    locais[MAX_PROFUNDIDADE + 2] = instrumentacao.alocacoes;
+    MPI_Reduce(locais, totais, MAX_PROFUNDIDADE + 3, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    double intervalo[2] = {instrumentacao.inicio - origem, instrumentacao.ocupado};
+    double* intervalos = rank == 0 ? (double*)malloc(2 * num_procs * sizeof(double)) : NULL;
+    MPI_Gather(intervalo, 2, MPI_DOUBLE, intervalos, 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank != 0) {
+        return;
+    }
+
+    double maximo = 0;
+    for (int r = 0; r < num_procs; r++) {
+        if (intervalos[2 * r + 1] > maximo) {
+            maximo = intervalos[2 * r + 1];
+        }
+    }
+    printf("Instrumentação (%d ranks):\n", num_procs);
+    for (int r = 0; r < num_procs; r++) {
+        printf("  Rank %d: ocupado %.6f s, ocioso %.6f s\n", r, intervalos[2 * r + 1], maximo - intervalos[2 * r + 1]);
+    }
+    printf("  Quadros por profundidade:");
+    for (int d = 0; d < MAX_PROFUNDIDADE; d++) {
+        if (totais[d] > 0) {
+            printf(" %d:%llu", d, (unsigned long long)totais[d]);
+        }
+    }
+    printf("\n  Total: candidatos %llu, sondagens %llu, alocações %llu\n",
+           (unsigned long long)totais[MAX_PROFUNDIDADE], (unsigned long long)totais[MAX_PROFUNDIDADE + 1],
+           (unsigned long long)totais[MAX_PROFUNDIDADE + 2]);
+
+    FILE* f = trilha != NULL ? fopen(trilha, "w") : NULL;
+    if (f != NULL) {
+        fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        for (int r = 0; r < num_procs; r++) {
+            fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"rank %d\"}},\n", r, r);
+            fprintf(f, "{\"name\": \"ocupado\", \"ph\": \"X\", \"pid\": %d, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f}%s\n",
+                    r, intervalos[2 * r] * 1e6, intervalos[2 * r + 1] * 1e6, r + 1 < num_procs ? "," : "");
+        }
+        fprintf(f, "]}\n");
+        fclose(f);
+        printf("Trilha gravada em %s\n", trilha);
+    } else if (trilha != NULL) {
+        fprintf(stderr, "Erro ao criar %s\n", trilha);
+    }
+    free(intervalos);
+}
+#endif
+
+// Memória por rank (mínimo, média e máximo) impressa pelo rank 0.
+void relatar_memoria(GrafoLocal* gl) {
+    double bytes = (double)bytes_grafo_local(gl);
+    double minimo, maximo, soma;
+    long buscas = gl->buscas_remotas, total_buscas;
+    MPI_Reduce(&bytes, &minimo, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&bytes, &maximo, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&bytes, &soma, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&buscas, &total_buscas, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (gl->rank == 0) {
+        printf("Memória do grafo por rank: mín %.2f MB, média %.2f MB, máx %.2f MB (%d ranks, %ld linhas buscadas via RMA)\n",
+               minimo / 1048576.0, soma / gl->num_procs / 1048576.0, maximo / 1048576.0,
+               gl->num_procs, total_buscas);
+    }
+}
+
+// Leitura coletiva. Cada rank obtém uma parte disjunta das arestas (pares
+// u v em "pares"), por MPI-IO sobre o texto ou a partir do arquivo binário
+// compartilhado no nó, e depois elas são trocadas entre os ranks.
+//
+// Formato binário: "KCLQBIN1", V (int64), E (int64) e E pares de int32 com
+// u < v, sem repetições.
+#define MAGICO_BINARIO "KCLQBIN1"
+#define CABECALHO_BINARIO (8 + 2 * sizeof(int64_t))
+
+static void anexar_aresta(int** pares, int64_t* n, int64_t* capacidade, int u, int v) {
+    if (*n == *capacidade) {
+        *capacidade = *capacidade * 2 + 1024;
+        *pares = (int*)realloc(*pares, *capacidade * 2 * sizeof(int));
+    }
+    (*pares)[2 * *n] = u;
+    (*pares)[2 * *n + 1] = v;
+    (*n)++;
+}
+
+// Cada rank lê [inicio, fim) do arquivo texto (mais uma margem para terminar
+// a última linha) e só interpreta as linhas que começam dentro da sua faixa.
+void ler_arestas_mpiio(const char* arquivo, int V, int rank, int num_procs, int** pares, int64_t* n) {
+    MPI_File fh;
+    if (MPI_File_open(MPI_COMM_WORLD, arquivo, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) {
+            printf("Erro ao abrir o arquivo!\n");
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Offset tamanho;
+    MPI_File_get_size(fh, &tamanho);
+    MPI_Offset inicio = tamanho * rank / num_procs;
+    MPI_Offset fim = tamanho * (rank + 1) / num_procs;
+    const MPI_Offset margem = 256;
+    MPI_Offset leitura_inicio = inicio > 0 ? inicio - 1 : 0;
+    MPI_Offset leitura_fim = fim + margem < tamanho ? fim + margem : tamanho;
+    MPI_Offset bytes = leitura_fim - leitura_inicio;
+    char* buffer = (char*)malloc(bytes + 1);
+
+    // MPI_File_read_at_all recebe "int": lê em pedaços, com o mesmo número de
+    // chamadas em todos os ranks.
+    const MPI_Offset pedaco = 1 << 30;
+    MPI_Offset maior = bytes;
+    MPI_Allreduce(MPI_IN_PLACE, &maior, 1, MPI_OFFSET, MPI_MAX, MPI_COMM_WORLD);
+    for (MPI_Offset feito = 0; feito < maior; feito += pedaco) {
+        MPI_Offset agora = bytes - feito;
+        if (agora < 0) {
+            agora = 0;
+        }
+        if (agora > pedaco) {
+            agora = pedaco;
+        }
+        MPI_File_read_at_all(fh, leitura_inicio + feito, buffer + (feito < bytes ? feito : bytes),
+                             (int)agora, MPI_CHAR, MPI_STATUS_IGNORE);
+    }
+    MPI_File_close(&fh);
+    buffer[bytes] = '\0';
+
+    // Pula a linha parcial: ela pertence ao rank anterior.
+    char* p = buffer;
+    if (inicio > 0) {
+        while (p < buffer + bytes && *p != '\n') {
+            p++;
+        }
+        p++;
+    }
+    char* limite = buffer + (fim - leitura_inicio);
+    int64_t capacidade = 0;
+    *pares = NULL;
+    *n = 0;
+    while (p < limite) {
+        char* fim_numero;
+        long u = strtol(p, &fim_numero, 10);
+        if (fim_numero == p) {
+            while (p < buffer + bytes && *p != '\n') {
+                p++;
+            }
+            p++;
+            continue;
+        }
+        p = fim_numero;
+        long v = strtol(p, &fim_numero, 10);
+        if (fim_numero != p && u >= 0 && u < V && v >= 0 && v < V) {
+            anexar_aresta(pares, n, &capacidade, (int)u, (int)v);
+        }
+        p = fim_numero;
+        while (p < buffer + bytes && *p != '\n') {
+            p++;
+        }
+        p++;
+    }
+    free(buffer);
+}
+
+// O líder de cada nó lê o arquivo binário inteiro para uma janela de memória
+// compartilhada (MPI_Win_allocate_shared); os ranks do nó leem dali a faixa
+// global de arestas que lhes cabe. A janela é liberada depois da troca.
+void ler_arestas_binario(const char* arquivo, int V, int rank, int num_procs, int** pares, int64_t* n) {
+    MPI_Comm no;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &no);
+    int rank_no;
+    MPI_Comm_rank(no, &rank_no);
+
+    int64_t cabecalho[2] = {0, 0};
+    FILE* f = NULL;
+    if (rank_no == 0) {
+        f = fopen(arquivo, "rb");
+        char magico[8];
+        if (f == NULL || fread(magico, 1, 8, f) != 8 || memcmp(magico, MAGICO_BINARIO, 8) != 0
+            || fread(cabecalho, sizeof(int64_t), 2, f) != 2) {
+            fprintf(stderr, "Erro ao ler o arquivo binário %s\n", arquivo);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (cabecalho[0] != V) {
+            fprintf(stderr, "%s tem %lld vértices, esperado %d\n", arquivo, (long long)cabecalho[0], V);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    MPI_Bcast(cabecalho, 2, MPI_INT64_T, 0, no);
+    int64_t E = cabecalho[1];
+
+    int* compartilhado;
+    MPI_Win janela;
+    MPI_Aint tamanho = rank_no == 0 ? (MPI_Aint)(E * 2 * sizeof(int)) : 0;
+    MPI_Win_allocate_shared(tamanho, sizeof(int), MPI_INFO_NULL, no, &compartilhado, &janela);
+    if (rank_no == 0) {
+        if (fread(compartilhado, sizeof(int), E * 2, f) != (size_t)(E * 2)) {
+            fprintf(stderr, "Arquivo binário %s truncado\n", arquivo);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        fclose(f);
+    } else {
+        MPI_Aint tamanho_lider;
+        int unidade;
+        MPI_Win_shared_query(janela, 0, &tamanho_lider, &unidade, &compartilhado);
+    }
+    MPI_Barrier(no);
+
+    int64_t de = E * rank / num_procs;
+    int64_t ate = E * (rank + 1) / num_procs;
+    *n = ate - de;
+    *pares = (int*)malloc((*n > 0 ? *n : 1) * 2 * sizeof(int));
+    memcpy(*pares, compartilhado + 2 * de, *n * 2 * sizeof(int));
+
+    MPI_Barrier(no);
+    MPI_Win_free(&janela);
+    MPI_Comm_free(&no);
+}
+
+// Orienta (menor -> maior), soma os graus orientados de todos os ranks,
+// particiona as faixas e envia cada aresta ao dono do menor extremo.
+GrafoLocal* montar_grafo_local(int V, int* pares, int64_t n, int rank, int num_procs) {
+    int* graus = (int*)calloc(V, sizeof(int));
+    for (int64_t i = 0; i < n; i++) {
+        int u = pares[2 * i], v = pares[2 * i + 1];
+        if (u > v) {
+            pares[2 * i] = v;
+            pares[2 * i + 1] = u;
+        }
+        if (u != v) {
+            graus[pares[2 * i]]++;
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, graus, V, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    int* limites = (int*)malloc((num_procs + 1) * sizeof(int));
+    particionar_faixas(graus, V, num_procs, limites);
+    free(graus);
+    GrafoLocal* gl = criar_grafo_local(V, rank, num_procs, limites);
+
+    int* envios = (int*)calloc(num_procs, sizeof(int));
+    int* recebimentos = (int*)calloc(num_procs, sizeof(int));
+    int* desl_envio = (int*)calloc(num_procs, sizeof(int));
+    int* desl_receb = (int*)calloc(num_procs, sizeof(int));
+    for (int64_t i = 0; i < n; i++) {
+        if (pares[2 * i] != pares[2 * i + 1]) {
+            envios[dono_de(gl, pares[2 * i])] += 2;
+        }
+    }
+    for (int r = 1; r < num_procs; r++) {
+        desl_envio[r] = desl_envio[r - 1] + envios[r - 1];
+    }
+    int total_envio = desl_envio[num_procs - 1] + envios[num_procs - 1];
+    int* saida = (int*)malloc((total_envio > 0 ? total_envio : 1) * sizeof(int));
+    int* cursor = (int*)malloc(num_procs * sizeof(int));
+    memcpy(cursor, desl_envio, num_procs * sizeof(int));
+    for (int64_t i = 0; i < n; i++) {
+        if (pares[2 * i] != pares[2 * i + 1]) {
+            int r = dono_de(gl, pares[2 * i]);
+            saida[cursor[r]++] = pares[2 * i];
+            saida[cursor[r]++] = pares[2 * i + 1];
+        }
+    }
+    MPI_Alltoall(envios, 1, MPI_INT, recebimentos, 1, MPI_INT, MPI_COMM_WORLD);
+    int total_receb = 0;
+    for (int r = 0; r < num_procs; r++) {
+        desl_receb[r] = total_receb;
+        total_receb += recebimentos[r];
+    }
+    int* entrada = (int*)malloc((total_receb > 0 ? total_receb : 1) * sizeof(int));
+    MPI_Alltoallv(saida, envios, desl_envio, MPI_INT,
+                  entrada, recebimentos, desl_receb, MPI_INT, MPI_COMM_WORLD);
+    free(saida);
+
+    // Linhas locais: contagem por vértice, preenchimento, ordenação e
+    // remoção de repetições.
+    int m = total_receb / 2;
+    int64_t* posicao = (int64_t*)calloc(gl->num_locais + 1, sizeof(int64_t));
+    for (int i = 0; i < m; i++) {
+        posicao[entrada[2 * i] - gl->primeiro + 1]++;
+    }
+    for (int i = 0; i < gl->num_locais; i++) {
+        posicao[i + 1] += posicao[i];
+    }
+    gl->arestas = (int*)malloc((m > 0 ? m : 1) * sizeof(int));
+    int64_t* escrita = (int64_t*)malloc((gl->num_locais + 1) * sizeof(int64_t));
+    memcpy(escrita, posicao, (gl->num_locais + 1) * sizeof(int64_t));
+    for (int i = 0; i < m; i++) {
+        gl->arestas[escrita[entrada[2 * i] - gl->primeiro]++] = entrada[2 * i + 1];
+    }
+    free(entrada);
+    free(escrita);
+    gl->inicio = (int64_t*)malloc((gl->num_locais + 1) * sizeof(int64_t));
+    int64_t pos = 0;
+    for (int i = 0; i < gl->num_locais; i++) {
+        gl->inicio[i] = pos;
+        int* linha = gl->arestas + posicao[i];
+        int tamanho = (int)(posicao[i + 1] - posicao[i]);
+        qsort(linha, tamanho, sizeof(int), comparar_int);
+        for (int j = 0; j < tamanho; j++) {
+            if (j == 0 || linha[j] != linha[j - 1]) {
+                gl->arestas[pos++] = linha[j];
+            }
+        }
+    }
+    gl->inicio[gl->num_locais] = pos;
+    free(posicao);
+
+    free(envios);
+    free(recebimentos);
+    free(desl_envio);
+    free(desl_receb);
+    free(cursor);
+    return gl;
+}
+
+// Modo replicado: todos os ranks recebem todas as arestas (MPI_Allgatherv).
+Grafo* montar_grafo_replicado(int V, int* pares, int64_t n, int num_procs) {
+    int local = (int)(2 * n);
+    int* contagens = (int*)malloc(num_procs * sizeof(int));
+    int* deslocamentos = (int*)malloc(num_procs * sizeof(int));
+    MPI_Allgather(&local, 1, MPI_INT, contagens, 1, MPI_INT, MPI_COMM_WORLD);
+    int total = 0;
+    for (int r = 0; r < num_procs; r++) {
+        deslocamentos[r] = total;
+        total += contagens[r];
+    }
+    int* todas = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    MPI_Allgatherv(pares, local, MPI_INT, todas, contagens, deslocamentos, MPI_INT, MPI_COMM_WORLD);
+    Grafo* g = criar_grafo(V);
+    for (int i = 0; i < total / 2; i++) {
+        adicionar_aresta(g, todas[2 * i], todas[2 * i + 1]);
+    }
+    free(todas);
+    free(contagens);
+    free(deslocamentos);
+    return g;
+}
+
+// Grava o grafo local no formato binário: cada rank escreve suas arestas
+// orientadas na posição dada pela soma exclusiva das contagens.
+void salvar_binario(GrafoLocal* gl, const char* arquivo) {
+    int64_t local = gl->inicio[gl->num_locais];
+    int64_t antes = 0, total = 0;
+    MPI_Exscan(&local, &antes, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (gl->rank == 0) {
+        antes = 0;
+    }
+    MPI_Allreduce(&local, &total, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+    int* pares = (int*)malloc((local > 0 ? local : 1) * 2 * sizeof(int));
+    for (int i = 0; i < gl->num_locais; i++) {
+        for (int64_t j = gl->inicio[i]; j < gl->inicio[i + 1]; j++) {
+            pares[2 * j] = gl->primeiro + i;
+            pares[2 * j + 1] = gl->arestas[j];
+        }
+    }
+    MPI_File fh;
+    MPI_File_open(MPI_COMM_WORLD, arquivo, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    MPI_File_set_size(fh, 0);
+    if (gl->rank == 0) {
+        int64_t cabecalho[2] = {gl->V, total};
+        MPI_File_write_at(fh, 0, MAGICO_BINARIO, 8, MPI_CHAR, MPI_STATUS_IGNORE);
+        MPI_File_write_at(fh, 8, cabecalho, 2, MPI_INT64_T, MPI_STATUS_IGNORE);
+    }
+    MPI_File_write_at_all(fh, CABECALHO_BINARIO + antes * 2 * sizeof(int), pares,
+                          (int)(local * 2), MPI_INT, MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+    free(pares);
+    if (gl->rank == 0) {
+        printf("Grafo salvo em %s (%lld arestas)\n", arquivo, (long long)total);
+    }
+}
+
+// Tempo de carga de cada rank, impresso pelo rank 0.
+void relatar_carga(double segundos, int64_t arestas_lidas, int rank, int num_procs) {
+    double tempos[num_procs];
+    int64_t lidas[num_procs];
+    MPI_Gather(&segundos, 1, MPI_DOUBLE, tempos, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(&arestas_lidas, 1, MPI_INT64_T, lidas, 1, MPI_INT64_T, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        double maximo = 0;
+        for (int r = 0; r < num_procs; r++) {
+            printf("Rank %d: tempo de carga %.6f segundos (%lld arestas)\n",
+                   r, tempos[r], (long long)lidas[r]);
+            if (tempos[r] > maximo) {
+                maximo = tempos[r];
+            }
+        }
+        printf("Tempo de carga: %.6f segundos\n", maximo);
+    }
+}
+
+// Procura "--nome=valor" nos argumentos opcionais.
+const char* obter_opcao(int argc, char* argv[], const char* nome) {
+    size_t n = strlen(nome);
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, nome, n) == 0
+            && argv[i][n + 2] == '=') {
+            return argv[i] + n + 3;
+        }
+    }
+    return NULL;
+}
+
+// Datasets fora da lista (por exemplo, gerados pelo gerador.c): o número de
+// vértices vem do cabeçalho de <dataset>.bin ou, sem ele, do maior ID em
+// <dataset>.edgelist mais um.
+int vertices_do_arquivo(const char* dataset) {
+    char arquivo[110];
+    snprintf(arquivo, sizeof(arquivo), "%s.bin", dataset);
+    FILE* f = fopen(arquivo, "rb");
+    if (f != NULL) {
+        char magico[8];
+        int64_t V;
+        bool ok = fread(magico, 1, 8, f) == 8 && memcmp(magico, MAGICO_BINARIO, 8) == 0
+                  && fread(&V, sizeof(V), 1, f) == 1;
+        fclose(f);
+        if (ok) {
+            return (int)V;
+        }
+    }
+    snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
+    f = fopen(arquivo, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    int u, v, maior = -1;
+    while (fscanf(f, "%d %d", &u, &v) == 2) {
+        maior = u > maior ? u : maior;
+        maior = v > maior ? v : maior;
+    }
+    fclose(f);
+    return maior + 1;
+}
+
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
 
@@ -181,15 +1427,15 @@ int main(int argc, char** argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
 
-    char dataset[30];
+    char dataset[100];
     int k;
 
     if (rank == 0) {
-        scanf("%s %d", dataset, &k);
+        scanf("%99s %d", dataset, &k);
     }
 
     MPI_Bcast(&k, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(dataset, 30, MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(dataset, sizeof(dataset), MPI_CHAR, 0, MPI_COMM_WORLD);
 
     int num_vertices;
     if (strcmp(dataset, "citeseer") == 0) {
@@ -199,27 +1445,166 @@ int main(int argc, char** argv) {
     } else if (strcmp(dataset, "dblp") == 0) {
         num_vertices = 317080;
     } else {
-        if (rank == 0) {
-            printf("Dataset desconhecido!\n");
+        num_vertices = rank == 0 ? vertices_do_arquivo(dataset) : 0;
+        MPI_Bcast(&num_vertices, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (num_vertices <= 0) {
+            if (rank == 0) {
+                printf("Dataset desconhecido!\n");
+            }
+            MPI_Finalize();
+            return 1;
         }
-        MPI_Finalize();
-        return 1;
     }
     
-    Grafo* g = criar_grafo(num_vertices);
-
     char arquivo[110];
     snprintf(arquivo, sizeof(arquivo), "%s.edgelist", dataset);
 
-    carregar_grafo_de_arquivo(g, arquivo);
+    // --distribuido[=vizinhanca|demanda]: cada rank guarda só as próprias
+    // linhas orientadas e recebe as dos vizinhos de uma vez ("vizinhanca") ou
+    // as busca por RMA quando precisa ("demanda").
+    const char* distribuido = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--distribuido") == 0) {
+            distribuido = "vizinhanca";
+        } else if (strncmp(argv[i], "--distribuido=", 14) == 0) {
+            distribuido = argv[i] + 14;
+        }
+    }
+
+    // --leitura=mpiio|binario: leitura coletiva (faixas de bytes do texto com
+    // MPI-IO, ou <dataset>.bin lido pelo líder de cada nó e compartilhado)
+    // seguida de troca de arestas. Sem ela, vale a leitura original.
+    const char* leitura = obter_opcao(argc, argv, "leitura");
+    const char* salvar = obter_opcao(argc, argv, "salvar-binario");
+
+    contagem_t resultado;
+    GrafoLocal* gl = NULL;
+    Grafo* g = NULL;
+    double inicio_carga = MPI_Wtime();
+    if (leitura != NULL && strcmp(leitura, "texto") != 0) {
+        int* pares;
+        int64_t n;
+        if (strcmp(leitura, "binario") == 0) {
+            char arquivo_binario[110];
+            snprintf(arquivo_binario, sizeof(arquivo_binario), "%s.bin", dataset);
+            ler_arestas_binario(arquivo_binario, num_vertices, rank, num_procs, &pares, &n);
+        } else {
+            ler_arestas_mpiio(arquivo, num_vertices, rank, num_procs, &pares, &n);
+        }
+        if (distribuido != NULL || salvar != NULL) {
+            gl = montar_grafo_local(num_vertices, pares, n, rank, num_procs);
+        }
+        if (distribuido == NULL) {
+            g = montar_grafo_replicado(num_vertices, pares, n, num_procs);
+        }
+        free(pares);
+        relatar_carga(MPI_Wtime() - inicio_carga, n, rank, num_procs);
+        if (salvar != NULL) {
+            salvar_binario(gl, salvar);
+            if (distribuido == NULL) {
+                liberar_grafo_local(gl);
+                gl = NULL;
+            }
+        }
+    } else if (distribuido != NULL) {
+        gl = distribuir_grafo(arquivo, num_vertices, rank, num_procs);
+        relatar_carga(MPI_Wtime() - inicio_carga, gl->inicio[gl->num_locais], rank, num_procs);
+    } else {
+        // Cada rank lê o arquivo inteiro.
+        g = criar_grafo(num_vertices);
+        int64_t lidas = carregar_grafo_de_arquivo(g, arquivo);
+        relatar_carga(MPI_Wtime() - inicio_carga, lidas, rank, num_procs);
+    }
+
+    double inicio_preproc = MPI_Wtime();
+
+    if (distribuido != NULL) {
+        if (strcmp(distribuido, "demanda") == 0) {
+            abrir_janelas(gl);
+        } else {
+            trocar_vizinhanca(gl);
+        }
+    }
+    double tempo_preproc = MPI_Wtime() - inicio_preproc;
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &tempo_preproc, &tempo_preproc, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    const char* trilha = obter_opcao(argc, argv, "trace");
+#ifndef INSTRUMENTAR
+    if (trilha != NULL && rank == 0) {
+        fprintf(stderr, "--trace requer compilação com -DINSTRUMENTAR; ignorado\n");
+    }
+#endif
+
+    // --checkpoint: cada rank grava as raízes concluídas a cada
+    // --intervalo-checkpoint segundos (padrão 60); se já há checkpoint, as
+    // raízes restantes são redistribuídas entre os ranks atuais.
+    const char* arquivo_checkpoint = obter_opcao(argc, argv, "checkpoint");
+    Checkpoint* checkpoint = NULL;
+    uint8_t* concluidas = NULL;
+    contagem_t parcial = 0;
+    int ranks_arquivos = 0;
+    if (arquivo_checkpoint != NULL) {
+        const char* intervalo = obter_opcao(argc, argv, "intervalo-checkpoint");
+        checkpoint = retomar_checkpoint(arquivo_checkpoint, dataset, k, num_vertices,
+                                        intervalo != NULL ? atof(intervalo) : 60.0,
+                                        rank, num_procs, &concluidas, &parcial, &ranks_arquivos);
+    }
 
-    int resultado = contagem_de_cliques_parallel(g, k, rank, num_procs);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double inicio_contagem = MPI_Wtime();
+    if (distribuido != NULL) {
+        resultado = contagem_de_cliques_distribuida(gl, k, concluidas, checkpoint);
+    } else {
+        resultado = contagem_de_cliques_parallel(g, k, rank, num_procs, concluidas, checkpoint);
+        liberar_grafo(g);
+    }
+    resultado += parcial;
+    double tempo_contagem = MPI_Wtime() - inicio_contagem;
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &tempo_contagem, &tempo_contagem, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
 
     if (rank == 0) {
-        printf("Número de cliques de tamanho %d: %d\n", k, resultado);
+        printf("Tempo de pré-processamento: %.6f segundos\n", tempo_preproc);
+        printf("Tempo de execução: %.6f segundos\n", tempo_contagem);
+        char texto_contagem[48];
+        printf("Número de cliques de tamanho %d: %s\n", k, formatar_contagem(resultado, texto_contagem));
     }
 
-    liberar_grafo(g);
+    if (checkpoint != NULL) {
+        // Custo: gravações e bytes somados, tempo do rank que mais gravou.
+        double custo[2] = {(double)checkpoint->gravacoes, (double)checkpoint->bytes}, custo_total[2];
+        double tempo_gravacao = checkpoint->tempo_gravacao;
+        MPI_Reduce(custo, custo_total, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &tempo_gravacao, &tempo_gravacao, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            printf("Checkpoints: %.0f gravações, %.2f KB, até %.6f segundos por rank (%.2f%% da contagem)\n",
+                   custo_total[0], custo_total[1] / 1024.0, tempo_gravacao,
+                   tempo_contagem > 0 ? 100.0 * tempo_gravacao / tempo_contagem : 0.0);
+        }
+        // Contagem completa: os arquivos não servem mais, inclusive os de
+        // ranks que só existiram em execuções anteriores com mais processos.
+        unlink(checkpoint->arquivo);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (rank == 0) {
+            for (int r = num_procs; r < ranks_arquivos; r++) {
+                char arquivo_rank[180];
+                snprintf(arquivo_rank, sizeof(arquivo_rank), "%s.%d", arquivo_checkpoint, r);
+                unlink(arquivo_rank);
+            }
+            unlink(arquivo_checkpoint);
+        }
+        liberar_checkpoint(checkpoint);
+        free(concluidas);
+    }
+
+    INSTR(relatar_instrumentacao(rank, num_procs, inicio_contagem, trilha));
+
+    if (gl != NULL) {
+        relatar_memoria(gl);
+        if (gl->sob_demanda) {
+            fechar_janelas(gl);
+        }
+        liberar_grafo_local(gl);
+    }
 
     MPI_Finalize();
     return 0;